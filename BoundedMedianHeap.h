@@ -0,0 +1,627 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    BoundedMedianHeap.h
+*/
+
+#ifndef _BOUNDEDMEDIANHEAP_H_
+#define _BOUNDEDMEDIANHEAP_H_
+
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+using namespace std;
+
+// what a full BoundedMedianHeap does with a new item
+enum OverflowPolicy {
+    REJECT_NEW,     // new item is dropped
+    EVICT_OLDEST,   // item inserted longest ago is removed
+    EVICT_MIN,      // current min is removed
+    EVICT_MAX,      // current max is removed
+    RESERVOIR       // keeps a uniform random sample of every item offered
+};
+
+// result of tryInsert
+enum InsertStatus {
+    INSERTED,   // item added, nothing removed
+    EVICTED,    // item added after removing one item
+    REJECTED    // item not added
+};
+
+// SlotHeap is a heap of slot numbers ordered by the items in those slots.
+// It records the position of every slot it holds, so any slot can be removed
+// in O(log n), not just the root.
+template <typename T>
+class SlotHeap {
+public:
+    SlotHeap(int cap, bool (*cmp) (const T&, const T&));   // constructor
+    SlotHeap(const SlotHeap<T>& other);     // copy constructor
+    ~SlotHeap();    // destructor
+    const SlotHeap<T>& operator=(const SlotHeap<T>& rhs); // overloaded assignment operator
+
+    void insert(int slot, const T* items);  // adds slot at end and bubbles up
+    void remove(int slot, const T* items);  // removes slot from wherever it is
+    int top() { return m_heap[1]; }         // slot at root
+    int size() { return m_heapSize; }
+
+private:
+    void place(int pos, int slot);  // puts slot at pos and records it
+    void bubbleUp(int pos, const T* items);
+    void trickleDown(int pos, const T* items);
+
+    int *m_heap;    // slots in heap order, 1 based
+    int *m_pos;     // position of each slot in m_heap, 0 if not in heap
+    int m_heapSize; // number of slots in heap
+    int m_heapCap;  // max number of slots
+    bool (*compare)(const T&, const T&);    // comparison operator
+};
+
+// BoundedMedianHeap is a MedianHeap that never throws when it is full.
+// tryInsert returns a status, and what happens to a new item when the heap is
+// full is set by an OverflowPolicy. Each half is kept in two SlotHeaps, one
+// ordered each way, so the median, min and max are all roots and any of them,
+// or the oldest item, can be removed in O(log n). Every policy costs the
+// same O(log n) per insert whether or not the heap is full.
+template <typename T>
+class BoundedMedianHeap {
+public:
+    // constructor for BoundedMedianHeap class
+    // must create a BoundedMedianHeap object capable of holding cap items
+    BoundedMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap=100,
+                       OverflowPolicy policy=REJECT_NEW ) ;
+
+    // copy constructor
+    BoundedMedianHeap(const BoundedMedianHeap<T>& otherH) ;
+
+    // destructor
+    ~BoundedMedianHeap() ;
+
+    // overloaded assignment operator
+    const BoundedMedianHeap<T>& operator=(const BoundedMedianHeap<T>& rhs) ;
+
+    // returns the total number of items in the BoundedMedianHeap
+    int size() ;
+
+    // returns the maximum number of items that can be stored in the BoundedMedianHeap
+    int capacity() ;
+
+    // changes what happens to new items when full
+    void setPolicy(OverflowPolicy policy) ;
+
+    // returns what happens to new items when full
+    OverflowPolicy getPolicy() ;
+
+    // adds item following the overflow policy, doesn't throw for a full heap,
+    // only copying T can throw
+    InsertStatus tryInsert(const T& item) noexcept(is_nothrow_copy_constructible<T>::value && is_nothrow_copy_assignable<T>::value) ;
+
+    // adds item, throws out_of_range if the policy rejects it
+    void insert(const T& item) ;
+
+    // returns a copy of the median key object
+    T getMedian() ;
+
+    // returns a copy of the minimum key object
+    T getMin() ;
+
+    // returns a copy of the maximum key object
+    T getMax() ;
+
+    // deletes specified item from BoundedMedianHeap, returns true if found and false if unfound
+    bool deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) ;
+
+    // prints out the contents of the BoundedMedianHeap from oldest to newest
+    void dump() ;
+
+private:
+    void add(const T& item);    // puts item in a free slot and the right half
+    void removeSlot(int slot);  // takes slot out of its half and the age list
+    void balance();     // moves a root across if halves differ by more than one
+    unsigned long long random();    // xorshift random number
+    void copyFrom(const BoundedMedianHeap<T>& other);  // deep copies other into host
+
+    T *m_items;     // item in each slot
+    bool *m_inLower;    // true if slot is in the lower half
+    int *m_older;   // slot inserted just before each slot, -1 if oldest
+    int *m_newer;   // slot inserted just after each slot, -1 if newest
+    int m_oldest;   // oldest slot, -1 if empty
+    int m_newest;   // newest slot, -1 if empty
+    int *m_free;    // stack of unused slots
+    int m_freeTop;  // number of unused slots
+
+    SlotHeap<T> *m_lowerMax;    // lower half, largest on top, holds the median
+    SlotHeap<T> *m_lowerMin;    // lower half, smallest on top
+    SlotHeap<T> *m_upperMin;    // upper half, smallest on top
+    SlotHeap<T> *m_upperMax;    // upper half, largest on top
+
+    OverflowPolicy m_policy;
+    unsigned long long m_seen;  // items offered, used by RESERVOIR
+    unsigned long long m_seed;  // state for random
+    int m_capacity; // capacity of heap
+    bool (*less) (const T&, const T&);
+    bool (*greater) (const T&, const T&);
+};
+
+//**************************** SlotHeap Class ******************************
+
+// SlotHeap class constructor
+// slots go from 0 to cap-1, none start in the heap
+template <typename T>
+SlotHeap<T>::SlotHeap(int cap, bool (*cmp) (const T&, const T&)) {
+    m_heap = new int[cap+1];
+    m_pos = new int[cap];
+    for (int i=0; i < cap; i++){
+        m_pos[i] = 0;
+    }
+    m_heapCap = cap;
+    m_heapSize = 0;
+    compare = cmp;
+}
+
+// SlotHeap class copy constructor
+template <typename T>
+SlotHeap<T>::SlotHeap(const SlotHeap<T>& other) {
+    m_heapCap = other.m_heapCap;
+    m_heapSize = other.m_heapSize;
+    compare = other.compare;
+    m_heap = new int[m_heapCap+1];
+    m_pos = new int[m_heapCap];
+    for (int i=1; i <= m_heapSize; i++){
+        m_heap[i] = other.m_heap[i];
+    }
+    for (int i=0; i < m_heapCap; i++){
+        m_pos[i] = other.m_pos[i];
+    }
+}
+
+// SlotHeap class destructor
+template <typename T>
+SlotHeap<T>::~SlotHeap() {
+    delete[] m_heap;
+    delete[] m_pos;
+    m_heap = NULL;
+    m_pos = NULL;
+}
+
+// SlotHeap class overloaded assignment operator
+template <typename T>
+const SlotHeap<T>& SlotHeap<T>::operator=(const SlotHeap<T>& rhs) {
+    // checks first for self-assignment, if true returns object
+    if(this == &rhs){
+        return *this;
+    }
+    delete[] m_heap;
+    delete[] m_pos;
+    m_heapCap = rhs.m_heapCap;
+    m_heapSize = rhs.m_heapSize;
+    compare = rhs.compare;
+    m_heap = new int[m_heapCap+1];
+    m_pos = new int[m_heapCap];
+    for (int i=1; i <= m_heapSize; i++){
+        m_heap[i] = rhs.m_heap[i];
+    }
+    for (int i=0; i < m_heapCap; i++){
+        m_pos[i] = rhs.m_pos[i];
+    }
+    return *this;
+}
+
+// puts slot at pos in heap and records its position
+template <typename T>
+void SlotHeap<T>::place(int pos, int slot) {
+    m_heap[pos] = slot;
+    m_pos[slot] = pos;
+}
+
+// adds slot at end of heap and bubbles it up
+template <typename T>
+void SlotHeap<T>::insert(int slot, const T* items) {
+    m_heapSize++;
+    place(m_heapSize, slot);
+    bubbleUp(m_heapSize, items);
+}
+
+// removes slot, filling its position with the last slot
+template <typename T>
+void SlotHeap<T>::remove(int slot, const T* items) {
+    int pos = m_pos[slot];
+    int last = m_heap[m_heapSize];
+    m_pos[slot] = 0;
+    m_heapSize--;
+    if (pos > m_heapSize){
+        return;
+    }
+    place(pos, last);
+    // if violates heap condition with parent, bubbleUp, else trickleDown
+    if (pos > 1 && compare(items[last], items[m_heap[pos/2]])){
+        bubbleUp(pos, items);
+    }
+    else {
+        trickleDown(pos, items);
+    }
+}
+
+// moves slot at pos up while its item comes before its parent's
+template <typename T>
+void SlotHeap<T>::bubbleUp(int pos, const T* items) {
+    int slot = m_heap[pos];
+    while (pos > 1 && compare(items[slot], items[m_heap[pos/2]])){
+        place(pos, m_heap[pos/2]);
+        pos = pos/2;
+    }
+    place(pos, slot);
+}
+
+// moves slot at pos down while a child's item comes before its item
+template <typename T>
+void SlotHeap<T>::trickleDown(int pos, const T* items) {
+    int slot = m_heap[pos];
+    while (2*pos <= m_heapSize){
+        int c = 2*pos;
+        // use right child if it comes before left
+        if (c + 1 <= m_heapSize && compare(items[m_heap[c+1]], items[m_heap[c]])){
+            c++;
+        }
+        if (!compare(items[m_heap[c]], items[slot])){
+            break;
+        }
+        place(pos, m_heap[c]);
+        pos = c;
+    }
+    place(pos, slot);
+}
+
+//*********************** BoundedMedianHeap Class **************************
+
+// constructor for BoundedMedianHeap class
+// every slot starts on the free stack
+template <typename T>
+BoundedMedianHeap<T>::BoundedMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap,
+                                         OverflowPolicy policy ) {
+    if (cap < 1){
+        throw out_of_range("Capacity must be at least one.");
+    }
+    m_capacity = cap;
+    m_policy = policy;
+    m_seen = 0;
+    m_seed = 88172645463325252ULL;
+    less = lt;
+    greater = gt;
+
+    m_items = new T[cap];
+    m_inLower = new bool[cap];
+    m_older = new int[cap];
+    m_newer = new int[cap];
+    m_free = new int[cap];
+    m_freeTop = 0;
+    for (int i = cap - 1; i >= 0; i--){
+        m_free[m_freeTop++] = i;
+    }
+    m_oldest = -1;
+    m_newest = -1;
+
+    m_lowerMax = new SlotHeap<T>(cap, gt);
+    m_lowerMin = new SlotHeap<T>(cap, lt);
+    m_upperMin = new SlotHeap<T>(cap, lt);
+    m_upperMax = new SlotHeap<T>(cap, gt);
+}
+
+// BoundedMedianHeap class copy constructor
+// creates a deep copy of the passed in BoundedMedianHeap object
+template <typename T>
+BoundedMedianHeap<T>::BoundedMedianHeap(const BoundedMedianHeap<T>& otherH) {
+    copyFrom(otherH);
+}
+
+// BoundedMedianHeap class destructor
+// deallocates any dynamically allocated memory
+template <typename T>
+BoundedMedianHeap<T>::~BoundedMedianHeap() {
+    delete[] m_items;
+    delete[] m_inLower;
+    delete[] m_older;
+    delete[] m_newer;
+    delete[] m_free;
+    delete m_lowerMax;
+    delete m_lowerMin;
+    delete m_upperMin;
+    delete m_upperMax;
+    m_capacity = 0;
+}
+
+// BoundedMedianHeap class overloaded assignment operator
+// deallocates memory of the host object and copies rhs into host
+template <typename T>
+const BoundedMedianHeap<T>& BoundedMedianHeap<T>::operator=(const BoundedMedianHeap<T>& rhs) {
+    // checks first for self-assignment, if true returns object
+    if(this == &rhs){
+        return *this;
+    }
+    delete[] m_items;
+    delete[] m_inLower;
+    delete[] m_older;
+    delete[] m_newer;
+    delete[] m_free;
+    delete m_lowerMax;
+    delete m_lowerMin;
+    delete m_upperMin;
+    delete m_upperMax;
+    copyFrom(rhs);
+    return *this;
+}
+
+// allocates arrays the same size as other's and copies every slot over
+template <typename T>
+void BoundedMedianHeap<T>::copyFrom(const BoundedMedianHeap<T>& other) {
+    m_capacity = other.m_capacity;
+    m_policy = other.m_policy;
+    m_seen = other.m_seen;
+    m_seed = other.m_seed;
+    m_oldest = other.m_oldest;
+    m_newest = other.m_newest;
+    m_freeTop = other.m_freeTop;
+    less = other.less;
+    greater = other.greater;
+
+    m_items = new T[m_capacity];
+    m_inLower = new bool[m_capacity];
+    m_older = new int[m_capacity];
+    m_newer = new int[m_capacity];
+    m_free = new int[m_capacity];
+    for (int i=0; i < m_capacity; i++){
+        m_items[i] = other.m_items[i];
+        m_inLower[i] = other.m_inLower[i];
+        m_older[i] = other.m_older[i];
+        m_newer[i] = other.m_newer[i];
+        m_free[i] = other.m_free[i];
+    }
+
+    m_lowerMax = new SlotHeap<T>(*(other.m_lowerMax));
+    m_lowerMin = new SlotHeap<T>(*(other.m_lowerMin));
+    m_upperMin = new SlotHeap<T>(*(other.m_upperMin));
+    m_upperMax = new SlotHeap<T>(*(other.m_upperMax));
+}
+
+// returns the total number of items in the BoundedMedianHeap
+template <typename T>
+int BoundedMedianHeap<T>::size() {
+    return m_capacity - m_freeTop;
+}
+
+// returns the maximum number of items that can be stored in the BoundedMedianHeap
+template <typename T>
+int BoundedMedianHeap<T>::capacity() {
+    return m_capacity;
+}
+
+// changes what happens to new items when full
+template <typename T>
+void BoundedMedianHeap<T>::setPolicy(OverflowPolicy policy) {
+    m_policy = policy;
+}
+
+// returns what happens to new items when full
+template <typename T>
+OverflowPolicy BoundedMedianHeap<T>::getPolicy() {
+    return m_policy;
+}
+
+// xorshift64, used to pick RESERVOIR replacements
+template <typename T>
+unsigned long long BoundedMedianHeap<T>::random() {
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 7;
+    m_seed ^= m_seed << 17;
+    return m_seed;
+}
+
+// adds item if there is room, otherwise follows the overflow policy
+// no path allocates, so only copying T can throw
+template <typename T>
+InsertStatus BoundedMedianHeap<T>::tryInsert(const T& item) noexcept(is_nothrow_copy_constructible<T>::value && is_nothrow_copy_assignable<T>::value) {
+    m_seen++;
+    if (size() < m_capacity){
+        add(item);
+        return INSERTED;
+    }
+
+    switch (m_policy){
+    case EVICT_OLDEST:
+        removeSlot(m_oldest);
+        break;
+    case EVICT_MIN:
+        removeSlot(m_lowerMin->size() > 0 ? m_lowerMin->top() : m_upperMin->top());
+        break;
+    case EVICT_MAX:
+        removeSlot(m_upperMax->size() > 0 ? m_upperMax->top() : m_lowerMax->top());
+        break;
+    case RESERVOIR: {
+        // keep the new item with chance capacity / seen, replacing a random
+        // slot, every slot is in use when full
+        unsigned long long j = random() % m_seen;
+        if (j >= (unsigned long long)m_capacity){
+            return REJECTED;
+        }
+        removeSlot((int)j);
+        break;
+    }
+    default:
+        return REJECTED;
+    }
+    add(item);
+    return EVICTED;
+}
+
+// adds item, throws out_of_range if the policy rejects it
+template <typename T>
+void BoundedMedianHeap<T>::insert(const T& item) {
+    if (tryInsert(item) == REJECTED){
+        throw out_of_range("The BoundedMedianHeap is full. Cannot insert item.");
+    }
+}
+
+// puts item in a free slot, links it as newest and adds it to the half it belongs in
+template <typename T>
+void BoundedMedianHeap<T>::add(const T& item) {
+    m_freeTop--;
+    int slot = m_free[m_freeTop];
+    m_items[slot] = item;
+
+    // link slot in as newest
+    m_older[slot] = m_newest;
+    m_newer[slot] = -1;
+    if (m_newest != -1){
+        m_newer[m_newest] = slot;
+    }
+    else {
+        m_oldest = slot;
+    }
+    m_newest = slot;
+
+    // if the item is less than median it belongs in the lower half
+    if (size() > 1 && less(item, getMedian())){
+        m_inLower[slot] = true;
+        m_lowerMax->insert(slot, m_items);
+        m_lowerMin->insert(slot, m_items);
+    }
+    else {
+        m_inLower[slot] = false;
+        m_upperMin->insert(slot, m_items);
+        m_upperMax->insert(slot, m_items);
+    }
+    balance();
+}
+
+// takes slot out of both heaps of its half and out of the age list
+template <typename T>
+void BoundedMedianHeap<T>::removeSlot(int slot) {
+    if (m_inLower[slot]){
+        m_lowerMax->remove(slot, m_items);
+        m_lowerMin->remove(slot, m_items);
+    }
+    else {
+        m_upperMin->remove(slot, m_items);
+        m_upperMax->remove(slot, m_items);
+    }
+
+    // unlink from age list
+    if (m_older[slot] != -1){
+        m_newer[m_older[slot]] = m_newer[slot];
+    }
+    else {
+        m_oldest = m_newer[slot];
+    }
+    if (m_newer[slot] != -1){
+        m_older[m_newer[slot]] = m_older[slot];
+    }
+    else {
+        m_newest = m_older[slot];
+    }
+
+    m_free[m_freeTop] = slot;
+    m_freeTop++;
+    balance();
+}
+
+// moves the root of the bigger half into the other if they differ by more than one
+template <typename T>
+void BoundedMedianHeap<T>::balance() {
+    if (m_lowerMax->size() > m_upperMin->size() + 1){
+        int slot = m_lowerMax->top();
+        m_lowerMax->remove(slot, m_items);
+        m_lowerMin->remove(slot, m_items);
+        m_inLower[slot] = false;
+        m_upperMin->insert(slot, m_items);
+        m_upperMax->insert(slot, m_items);
+    }
+    else if (m_upperMin->size() > m_lowerMax->size() + 1){
+        int slot = m_upperMin->top();
+        m_upperMin->remove(slot, m_items);
+        m_upperMax->remove(slot, m_items);
+        m_inLower[slot] = true;
+        m_lowerMax->insert(slot, m_items);
+        m_lowerMin->insert(slot, m_items);
+    }
+}
+
+// returns a copy of the median key object
+// for an even number of items this is the lower middle, same as MedianHeap
+template <typename T>
+T BoundedMedianHeap<T>::getMedian() {
+    if (size() == 0){
+        throw out_of_range("The BoundedMedianHeap is empty.");
+    }
+    if (m_upperMin->size() > m_lowerMax->size()){
+        return m_items[m_upperMin->top()];
+    }
+    return m_items[m_lowerMax->top()];
+}
+
+// returns a copy of the min key object
+template <typename T>
+T BoundedMedianHeap<T>::getMin() {
+    if (size() == 0){
+        throw out_of_range("The BoundedMedianHeap is empty.");
+    }
+    if (m_lowerMin->size() > 0){
+        return m_items[m_lowerMin->top()];
+    }
+    return m_items[m_upperMin->top()];
+}
+
+// returns a copy of the max key object
+template <typename T>
+T BoundedMedianHeap<T>::getMax() {
+    if (size() == 0){
+        throw out_of_range("The BoundedMedianHeap is empty.");
+    }
+    if (m_upperMax->size() > 0){
+        return m_items[m_upperMax->top()];
+    }
+    return m_items[m_lowerMax->top()];
+}
+
+// looks for givenItem from oldest to newest and if found deletes item and returns true
+// if unfound, BoundedMedianHeap is unchanged and returns false
+template <typename T>
+bool BoundedMedianHeap<T>::deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) {
+    // if the BoundedMedianHeap is empty throw out of range error
+    if (size() == 0){
+        throw out_of_range("The heap is empty, cannot remove item.");
+    }
+    for (int slot = m_oldest; slot != -1; slot = m_newer[slot]){
+        if (equalTo(m_items[slot], givenItem)){
+            givenItem = m_items[slot];
+            removeSlot(slot);
+            return true;
+        }
+    }
+    return false;
+}
+
+// prints out items from oldest to newest and which half they are in
+template <typename T>
+void BoundedMedianHeap<T>::dump() {
+    cout << "... BoundedMedianHeap()::dump() ..." << endl;
+    cout << endl;
+    cout << "size = " << size() << ", ";
+    cout << "capacity = " << m_capacity << ", ";
+    cout << "lower = " << m_lowerMax->size() << ", ";
+    cout << "upper = " << m_upperMin->size() << endl;
+    int i = 1;
+    for (int slot = m_oldest; slot != -1; slot = m_newer[slot]){
+        cout << "Item[" << i << "] = (" << m_items[slot] << ")";
+        cout << (m_inLower[slot] ? " lower" : " upper") << endl;
+        i++;
+    }
+    cout << "--------------------------------" << endl;
+    if (size() > 0){
+        cout << "min    = " << getMin() << endl;
+        cout << "median = " << getMedian() << endl;
+        cout << "max    = " << getMax() << endl;
+    }
+}
+
+#endif
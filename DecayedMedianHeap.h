@@ -0,0 +1,438 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    DecayedMedianHeap.h
+*/
+
+#ifndef _DECAYEDMEDIANHEAP_H_
+#define _DECAYEDMEDIANHEAP_H_
+
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+#include "MedianHeap.h"
+using namespace std;
+
+// DecayedMedianHeap finds the weighted median of timed samples, where a sample
+// counts half as much for every halfLife that passes after it arrives. Rather
+// than shrinking every weight on each tick, a new sample gets weight
+// 2^((time - base) / halfLife), so only newer samples count more and the
+// relative weights come out the same. When new weights get near the top of a
+// double, every weight is scaled back down and base moves up to the newest time.
+// The max heap holds the lower items and the min heap the upper ones, and
+// balance() moves roots across until the max heap's root is the lowest item at
+// which the weight at or below it reaches half the total. With equal weights
+// that is the same median as MedianHeap. Samples more than PRUNE_HALF_LIVES
+// older than the newest count for almost nothing, and once the oldest is twice
+// that old they are all dropped in one pass that rebuilds the heaps. Samples are
+// compared with < and >, and times must never go backward.
+template <typename T>
+class DecayedMedianHeap {
+public:
+    // what the heaps hold for each sample
+    struct Entry {
+        T item;
+        double weight;  // 2^((time - base) / halfLife) when it was inserted
+    };
+
+    // constructor for DecayedMedianHeap class
+    // must create a DecayedMedianHeap object capable of holding cap samples
+    DecayedMedianHeap( double halfLife, int cap=100 ) ;
+
+    // copy constructor
+    DecayedMedianHeap(const DecayedMedianHeap<T>& otherH) ;
+
+    // destructor
+    ~DecayedMedianHeap() ;
+
+    // overloaded assignment operator
+    const DecayedMedianHeap<T>& operator=(const DecayedMedianHeap<T>& rhs) ;
+
+    // returns the number of samples held, including ones not yet pruned
+    int size() ;
+
+    // returns the maximum number of samples that can be stored
+    int capacity() ;
+
+    // adds item seen at time, prunes old samples first if it is time or if full
+    void insert(const T& item, double time) ;
+
+    // returns a copy of the weighted median
+    T getMedian() ;
+
+    // returns a copy of the minimum sample held
+    T getMin() ;
+
+    // returns a copy of the maximum sample held
+    T getMax() ;
+
+    // deletes specified item, returns true if found and false if unfound
+    bool deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) ;
+
+    // drops every sample weighing less than 2^-PRUNE_HALF_LIVES of one at time
+    // returns the number dropped
+    int prune(double time) ;
+
+    // prints out the samples and weights in each heap
+    void dump() ;
+
+    static const int PRUNE_HALF_LIVES = 40;     // age at which a sample is negligible
+    static const int RESCALE_HALF_LIVES = 512;  // age of base at which weights are rescaled
+
+private:
+    // functions order entries by item alone
+    static bool entryLess(const Entry& a, const Entry& b) { return a.item < b.item; }
+    static bool entryGreater(const Entry& a, const Entry& b) { return a.item > b.item; }
+
+    // matches entries lighter than cutoff
+    struct Lighter {
+        double cutoff;
+        bool operator()(const Entry& e) const { return e.weight < cutoff; }
+    };
+
+    double weightAt(double time) ;  // weight a sample at time gets
+    void rescale(double time) ;     // moves base to time and scales weights to match
+    void recount() ;    // adds up weights and finds oldest, min and max again
+    void taken(Heap<Entry> *from, double weight) ;  // recounts if taking weight from from may have left rounding
+    void balance() ;    // moves roots until max heap root is the weighted median
+    void moveTop(Heap<Entry> *from, Heap<Entry> *to) ;  // moves root of from to to
+    void copyFrom(const DecayedMedianHeap<T>& other) ;  // deep copies other into host
+
+    Heap<Entry> *minHeap;   // min heap of upper samples
+    Heap<Entry> *maxHeap;   // max heap of lower samples
+    double m_lowWeight;     // total weight in maxHeap
+    double m_highWeight;    // total weight in minHeap
+    double m_oldest;    // lightest weight held, or newer if it was deleted
+    double m_halfLife;
+    double m_base;      // time with weight 1
+    double m_lastTime;  // latest time inserted, -HUGE_VAL before the first
+    int m_takes;        // weights taken out of a total since the last recount
+    T m_min;    // min sample held
+    T m_max;    // max sample held
+    int m_capacity;
+};
+
+// constructor for DecayedMedianHeap class
+// either heap may end up holding almost every sample, so each can hold cap
+template <typename T>
+DecayedMedianHeap<T>::DecayedMedianHeap( double halfLife, int cap ) {
+    if (!(halfLife > 0)){
+        throw out_of_range("Half life must be more than 0.");
+    }
+    m_capacity = cap;
+    maxHeap = new Heap<Entry>(cap, entryGreater);
+    minHeap = new Heap<Entry>(cap, entryLess);
+    m_lowWeight = 0;
+    m_highWeight = 0;
+    m_oldest = 0;
+    m_halfLife = halfLife;
+    m_base = 0;
+    m_lastTime = -HUGE_VAL;
+    m_takes = 0;
+}
+
+// DecayedMedianHeap class copy constructor
+template <typename T>
+DecayedMedianHeap<T>::DecayedMedianHeap(const DecayedMedianHeap<T>& otherH) {
+    copyFrom(otherH);
+}
+
+// DecayedMedianHeap class destructor
+// deallocates any dynamically allocated memory
+template <typename T>
+DecayedMedianHeap<T>::~DecayedMedianHeap() {
+    delete maxHeap;
+    delete minHeap;
+    maxHeap = NULL;
+    minHeap = NULL;
+    m_capacity = 0;
+}
+
+// DecayedMedianHeap class overloaded assignment operator
+// deallocates memory of the host object and copies rhs into host
+template <typename T>
+const DecayedMedianHeap<T>& DecayedMedianHeap<T>::operator=(const DecayedMedianHeap<T>& rhs) {
+    // checks first for self-assignment, if true returns object
+    if(this == &rhs){
+        return *this;
+    }
+    delete maxHeap;
+    delete minHeap;
+    copyFrom(rhs);
+    return *this;
+}
+
+// copies every member of other, heaps are deep copied
+template <typename T>
+void DecayedMedianHeap<T>::copyFrom(const DecayedMedianHeap<T>& other) {
+    maxHeap = new Heap<Entry>(*(other.maxHeap));
+    minHeap = new Heap<Entry>(*(other.minHeap));
+    m_lowWeight = other.m_lowWeight;
+    m_highWeight = other.m_highWeight;
+    m_oldest = other.m_oldest;
+    m_halfLife = other.m_halfLife;
+    m_base = other.m_base;
+    m_lastTime = other.m_lastTime;
+    m_takes = other.m_takes;
+    m_min = other.m_min;
+    m_max = other.m_max;
+    m_capacity = other.m_capacity;
+}
+
+// returns the number of samples held
+template <typename T>
+int DecayedMedianHeap<T>::size() {
+    return maxHeap->m_heapSize + minHeap->m_heapSize;
+}
+
+// returns the maximum number of samples that can be stored
+template <typename T>
+int DecayedMedianHeap<T>::capacity() {
+    return m_capacity;
+}
+
+// returns the weight of a sample inserted at time
+template <typename T>
+double DecayedMedianHeap<T>::weightAt(double time) {
+    return exp2((time - m_base) / m_halfLife);
+}
+
+// moves base to time, every weight is multiplied by the same factor so the
+// median doesn't change, weights too small to matter become 0
+template <typename T>
+void DecayedMedianHeap<T>::rescale(double time) {
+    double factor = exp2((m_base - time) / m_halfLife);
+    for (int i=1; i <= maxHeap->m_heapSize; i++){
+        maxHeap->m_heap[i].weight *= factor;
+    }
+    for (int i=1; i <= minHeap->m_heapSize; i++){
+        minHeap->m_heap[i].weight *= factor;
+    }
+    m_base = time;
+}
+
+// adds up the weights again, which also clears rounding left by moves
+template <typename T>
+void DecayedMedianHeap<T>::recount() {
+    m_lowWeight = 0;
+    m_highWeight = 0;
+    m_takes = 0;
+    m_oldest = HUGE_VAL;
+    for (int i=1; i <= maxHeap->m_heapSize; i++){
+        const Entry& e = maxHeap->m_heap[i];
+        m_lowWeight += e.weight;
+        m_oldest = min(m_oldest, e.weight);
+        if (i == 1 || e.item < m_min){
+            m_min = e.item;
+        }
+    }
+    for (int i=1; i <= minHeap->m_heapSize; i++){
+        const Entry& e = minHeap->m_heap[i];
+        m_highWeight += e.weight;
+        m_oldest = min(m_oldest, e.weight);
+        if (i == 1 || e.item > m_max){
+            m_max = e.item;
+        }
+    }
+    if (maxHeap->m_heapSize > 0 && minHeap->m_heapSize == 0){
+        m_max = maxHeap->m_heap[1].item;
+    }
+    if (minHeap->m_heapSize > 0 && maxHeap->m_heapSize == 0){
+        m_min = minHeap->m_heap[1].item;
+    }
+}
+
+// weights span up to 2^(2 * PRUNE_HALF_LIVES), so taking one out of a total
+// can leave rounding behind. Taking out at least half a side's total leaves
+// mostly rounding, as the lighter weights were lost when they were added to
+// the heavy one, so that side is recounted, as is a side that empties. Once
+// there have been as many takes as samples everything is recounted too,
+// which keeps the rounding from piling up at O(1) amortized cost
+template <typename T>
+void DecayedMedianHeap<T>::taken(Heap<Entry> *from, double weight) {
+    double left = from == maxHeap ? m_lowWeight : m_highWeight;
+    m_takes++;
+    if (from->m_heapSize == 0 || left <= weight || m_takes > size()){
+        recount();
+    }
+}
+
+// drops every sample that weighs less than 2^-PRUNE_HALF_LIVES of a new one
+template <typename T>
+int DecayedMedianHeap<T>::prune(double time) {
+    Lighter lighter;
+    lighter.cutoff = weightAt(time - PRUNE_HALF_LIVES * m_halfLife);
+    int removed = maxHeap->deleteAll(lighter) + minHeap->deleteAll(lighter);
+    recount();
+    balance();
+    return removed;
+}
+
+// removes root of from and inserts it into to, carrying its weight across
+template <typename T>
+void DecayedMedianHeap<T>::moveTop(Heap<Entry> *from, Heap<Entry> *to) {
+    Entry e = from->m_heap[1];
+    from->deleteH(1);
+    to->insert(e);
+    if (from == maxHeap){
+        m_lowWeight -= e.weight;
+        m_highWeight += e.weight;
+    } else {
+        m_highWeight -= e.weight;
+        m_lowWeight += e.weight;
+    }
+    taken(from, e.weight);
+}
+
+// first fills the max heap until it holds half the weight, then gives back
+// roots it can spare and still hold half, so its root is the weighted median
+// half is taken again each time, since a move may recount the totals
+template <typename T>
+void DecayedMedianHeap<T>::balance() {
+    while (minHeap->m_heapSize > 0 && (m_lowWeight < (m_lowWeight + m_highWeight) / 2 || maxHeap->m_heapSize == 0)){
+        moveTop(minHeap, maxHeap);
+    }
+    while (maxHeap->m_heapSize > 1 && m_lowWeight - maxHeap->m_heap[1].weight >= (m_lowWeight + m_highWeight) / 2){
+        moveTop(maxHeap, minHeap);
+    }
+}
+
+// adds item to the lower samples if it isn't above the median, else the upper
+template <typename T>
+void DecayedMedianHeap<T>::insert(const T& item, double time) {
+    if (time < m_lastTime){
+        throw out_of_range("Samples must be inserted in time order.");
+    }
+    if (size() == 0){
+        m_base = time;
+    }
+    m_lastTime = time;
+    if (time - m_base > RESCALE_HALF_LIVES * m_halfLife){
+        rescale(time);
+        prune(time);
+    }
+    // the oldest sample is twice the negligible age, or there is no room
+    else if (size() > 0 && (m_oldest < weightAt(time - 2 * PRUNE_HALF_LIVES * m_halfLife) || size() == capacity())){
+        prune(time);
+    }
+    if (size() == capacity()){
+        throw out_of_range("The DecayedMedianHeap is full. Cannot insert item.");
+    }
+
+    Entry e;
+    e.item = item;
+    e.weight = weightAt(time);
+    if (size() == 0){
+        m_min = item;
+        m_max = item;
+        m_oldest = e.weight;
+    }
+    if (item < m_min){
+        m_min = item;
+    }
+    if (item > m_max){
+        m_max = item;
+    }
+    if (maxHeap->m_heapSize == 0 || !(item > maxHeap->m_heap[1].item)){
+        maxHeap->insert(e);
+        m_lowWeight += e.weight;
+    } else {
+        minHeap->insert(e);
+        m_highWeight += e.weight;
+    }
+    balance();
+}
+
+// returns a copy of the weighted median
+template <typename T>
+T DecayedMedianHeap<T>::getMedian() {
+    if(size() == 0){
+        throw out_of_range("The DecayedMedianHeap is empty.");
+    }
+    return maxHeap->m_heap[1].item;
+}
+
+// returns a copy of the min sample held
+template <typename T>
+T DecayedMedianHeap<T>::getMin() {
+    if(size() == 0){
+        throw out_of_range("The DecayedMedianHeap is empty.");
+    }
+    return m_min;
+}
+
+// returns a copy of the max sample held
+template <typename T>
+T DecayedMedianHeap<T>::getMax() {
+    if(size() == 0){
+        throw out_of_range("The DecayedMedianHeap is empty.");
+    }
+    return m_max;
+}
+
+// looks for givenItem and if found deletes the sample and returns true
+// if unfound, DecayedMedianHeap is unchanged and returns false
+template <typename T>
+bool DecayedMedianHeap<T>::deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) {
+    // if the DecayedMedianHeap is empty throw out of range error
+    if(size() == 0) {
+        throw out_of_range("The heap is empty, cannot remove item.");
+    }
+    Heap<Entry> *heaps[2] = {maxHeap, minHeap};
+    for (int h=0; h < 2; h++){
+        for (int i=1; i <= heaps[h]->m_heapSize; i++){
+            Entry e = heaps[h]->m_heap[i];
+            if (equalTo(e.item, givenItem)){
+                givenItem = e.item;
+                heaps[h]->deleteH(i);
+                if (h == 0){
+                    m_lowWeight -= e.weight;
+                } else {
+                    m_highWeight -= e.weight;
+                }
+                // min and max may have been the deleted sample
+                if (!(e.item > m_min) || !(e.item < m_max)){
+                    double oldest = m_oldest;
+                    recount();
+                    m_oldest = oldest;
+                } else {
+                    taken(heaps[h], e.weight);
+                }
+                balance();
+                return true;
+            }
+        }
+    }
+    // if unfound
+    return false;
+}
+
+// prints out the samples and weights in each heap
+template <typename T>
+void DecayedMedianHeap<T>::dump() {
+    cout << "... DecayedMedianHeap()::dump() ..." << endl;
+    cout << endl;
+    cout << "size = " << size() << ", ";
+    cout << "capacity = " << m_capacity << ", ";
+    cout << "half life = " << m_halfLife << endl;
+    cout << "------------Max Heap------------" << endl;
+    cout << "weight = " << m_lowWeight << endl;
+    for (int i=1; i <= maxHeap->m_heapSize; i++){
+        cout << "Heap[" << i << "] = (" << maxHeap->m_heap[i].item << ", " << maxHeap->m_heap[i].weight << ")" << endl;
+    }
+    cout << "------------Min Heap------------" << endl;
+    cout << "weight = " << m_highWeight << endl;
+    for (int i=1; i <= minHeap->m_heapSize; i++){
+        cout << "Heap[" << i << "] = (" << minHeap->m_heap[i].item << ", " << minHeap->m_heap[i].weight << ")" << endl;
+    }
+    cout << "--------------------------------" << endl;
+    if (size() > 0){
+        cout << "min    = " << getMin() << endl;
+        cout << "median = " << getMedian() << endl;
+        cout << "max    = " << getMax() << endl;
+    }
+}
+
+#endif
@@ -0,0 +1,449 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    ExternalMedian.h
+*/
+
+#ifndef _EXTERNALMEDIAN_H_
+#define _EXTERNALMEDIAN_H_
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <queue>
+#include <type_traits>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+using namespace std;
+
+// ExternalMedian finds the exact median, or any quantile, of more items than
+// fit in memory. Items collect in a buffer of memItems; a full buffer is
+// sorted and written to a run file in tempDir. Runs are merged in levels:
+// whenever fanIn runs of the same level pile up they become one run of the
+// next level, so each item is rewritten once per level, about log base fanIn
+// of (items / memItems) times. A query merges the runs and the buffer in one
+// sequential read, stopping at the largest rank asked for. Inserts and merges
+// use only the memItems buffer, a query reads through up to another memItems.
+// T is written to disk as raw bytes, so it must be trivially copyable.
+// Run files get unique names, but a forked copy still shares the runs written
+// before the fork, so only one side of a fork should go on using it.
+template <typename T>
+class ExternalMedian {
+    static_assert(is_trivially_copyable<T>::value, "ExternalMedian needs a trivially copyable type");
+public:
+    // constructor for ExternalMedian class
+    ExternalMedian( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&),
+                    int memItems=1<<20, int fanIn=64, const string& tempDir="/tmp" ) ;
+
+    // destructor, removes every run file
+    ~ExternalMedian() ;
+
+    // adds item, writing a run file if the buffer is full
+    void insert(const T& item) ;
+
+    // returns the total number of items added
+    long long size() ;
+
+    // returns the number of run files on disk
+    int runs() ;
+
+    // returns a copy of the median, the lower middle for an even count
+    T getMedian() ;
+
+    // returns a copy of the k-th smallest item, k goes from 1 to size()
+    T select(long long k) ;
+
+    // returns a copy of the q quantile, q from 0 to 1, using the nearest rank
+    T getQuantile(double q) ;
+
+    // finds count quantiles in a single pass, out[i] gets the qs[i] quantile
+    void quantiles(const double* qs, int count, T* out) ;
+
+    // returns the total number of items written to run files so far
+    long long itemsWritten() ;
+
+private:
+    ExternalMedian(const ExternalMedian<T>& other);     // not copyable
+    const ExternalMedian<T>& operator=(const ExternalMedian<T>& rhs);
+
+    // one sorted input to a merge, a run file or the sorted buffer
+    struct Source {
+        FILE *file;     // NULL for the buffer
+        T *buf;         // items read so far
+        int pos;        // next item in buf
+        int len;        // number of items in buf
+        int cap;        // size of buf when reading a file
+    };
+
+    // orders sources by their current item, smallest on top of priority_queue
+    struct HeadAfter {
+        vector<Source> *sources;
+        bool (*less) (const T&, const T&);
+        bool operator()(int a, int b) const {
+            return less((*sources)[b].buf[(*sources)[b].pos], (*sources)[a].buf[(*sources)[a].pos]);
+        }
+    };
+
+    void spill();   // sorts buffer and writes it as a run
+    void mergeRuns(int first, int last);    // merges runs first to last-1 into one run
+    bool advance(Source& s);    // moves s to its next item, false when it runs out
+    long long rankFor(double q);    // nearest rank of quantile q
+    FILE* newRun(string& path);    // creates the next run file, sets path to its name
+    void selectRanks(const long long* ranks, int count, T* out);  // finds items at ranks in one merge
+
+    T *m_buffer;    // items not yet written
+    int m_bufSize;  // number of items in m_buffer
+    int m_memItems; // size of m_buffer
+    int m_fanIn;    // most runs merged at once
+    string m_tempDir;
+    vector<string> m_runs;  // paths of run files on disk
+    vector<int> m_levels;   // merge level of each run, never rising toward the back
+    long long m_size;   // total items added
+    long long m_written;    // total items written to disk
+
+    bool (*less) (const T&, const T&);
+    bool (*greater) (const T&, const T&);
+};
+
+// constructor for ExternalMedian class
+template <typename T>
+ExternalMedian<T>::ExternalMedian( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&),
+                                   int memItems, int fanIn, const string& tempDir ) {
+    if (fanIn < 2 || memItems <= fanIn){
+        throw out_of_range("fanIn must be at least 2 and memItems more than fanIn.");
+    }
+    m_memItems = memItems;
+    m_fanIn = fanIn;
+    m_tempDir = tempDir;
+    m_buffer = new T[memItems];
+    m_bufSize = 0;
+    m_size = 0;
+    m_written = 0;
+    less = lt;
+    greater = gt;
+}
+
+// ExternalMedian class destructor
+// deallocates buffer and deletes any run files left
+template <typename T>
+ExternalMedian<T>::~ExternalMedian() {
+    for (size_t i=0; i < m_runs.size(); i++){
+        remove(m_runs[i].c_str());
+    }
+    delete[] m_buffer;
+    m_buffer = NULL;
+}
+
+// creates a new file in tempDir and opens it for writing, returns NULL if it can't
+// mkstemp picks a name no other file has, so forked copies and other
+// processes sharing tempDir never write to each other's runs
+template <typename T>
+FILE* ExternalMedian<T>::newRun(string& path) {
+    string name = m_tempDir + "/median_run_XXXXXX";
+    vector<char> buf(name.begin(), name.end());
+    buf.push_back('\0');
+    int fd = mkstemp(&buf[0]);
+    if (fd < 0){
+        path = name;
+        return NULL;
+    }
+    path = &buf[0];
+    FILE *f = fdopen(fd, "wb");
+    if (f == NULL){
+        close(fd);
+        remove(path.c_str());
+    }
+    return f;
+}
+
+// adds item to buffer, spilling first if buffer is full
+template <typename T>
+void ExternalMedian<T>::insert(const T& item) {
+    if (m_bufSize == m_memItems){
+        spill();
+    }
+    m_buffer[m_bufSize] = item;
+    m_bufSize++;
+    m_size++;
+}
+
+// returns the total number of items added
+template <typename T>
+long long ExternalMedian<T>::size() {
+    return m_size;
+}
+
+// returns the number of run files on disk
+template <typename T>
+int ExternalMedian<T>::runs() {
+    return (int)m_runs.size();
+}
+
+// returns the total number of items written to run files
+template <typename T>
+long long ExternalMedian<T>::itemsWritten() {
+    return m_written;
+}
+
+// sorts buffer and writes it out as a new run, then merges if fanIn runs are waiting
+template <typename T>
+void ExternalMedian<T>::spill() {
+    sort(m_buffer, m_buffer + m_bufSize, less);
+    string path;
+    FILE *f = newRun(path);
+    if (f == NULL){
+        throw runtime_error("Could not create run file " + path);
+    }
+    size_t wrote = fwrite(m_buffer, sizeof(T), m_bufSize, f);
+    fclose(f);
+    if (wrote != (size_t)m_bufSize){
+        remove(path.c_str());
+        throw runtime_error("Could not write run file " + path);
+    }
+    m_runs.push_back(path);
+    m_levels.push_back(0);
+    m_written += m_bufSize;
+    m_bufSize = 0;
+
+    // like carrying in a base fanIn counter, fanIn runs of one level become
+    // one run of the next, which may in turn complete that level
+    int n = (int)m_runs.size();
+    while (n >= m_fanIn && m_levels[n - m_fanIn] == m_levels[n - 1]){
+        mergeRuns(n - m_fanIn, n);
+        n = (int)m_runs.size();
+    }
+}
+
+// refills buffer of a file source, or steps through the sorted buffer
+template <typename T>
+bool ExternalMedian<T>::advance(Source& s) {
+    s.pos++;
+    if (s.pos < s.len){
+        return true;
+    }
+    if (s.file == NULL){
+        return false;
+    }
+    s.len = (int)fread(s.buf, sizeof(T), s.cap, s.file);
+    s.pos = 0;
+    return s.len > 0;
+}
+
+// merges runs first to last-1 into a single run one level up that replaces them
+// only called right after a spill, so the empty buffer is split up for the
+// read buffer of each run and one write buffer
+template <typename T>
+void ExternalMedian<T>::mergeRuns(int first, int last) {
+    int n = last - first;
+    int chunk = m_memItems / (n + 1);
+    T *space = m_buffer;
+
+    vector<Source> sources(n);
+    HeadAfter after;
+    after.sources = &sources;
+    after.less = less;
+    priority_queue<int, vector<int>, HeadAfter> heads(after);
+    for (int i=0; i < n; i++){
+        Source& s = sources[i];
+        s.file = fopen(m_runs[first + i].c_str(), "rb");
+        if (s.file == NULL){
+            for (int j=0; j < i; j++){
+                fclose(sources[j].file);
+            }
+            throw runtime_error("Could not open run file " + m_runs[first + i]);
+        }
+        s.buf = space + (size_t)chunk * i;
+        s.cap = chunk;
+        s.pos = -1;
+        s.len = 0;
+        if (advance(s)){
+            heads.push(i);
+        }
+    }
+
+    string path;
+    FILE *out = newRun(path);
+    if (out == NULL){
+        for (int i=0; i < n; i++){
+            fclose(sources[i].file);
+        }
+        throw runtime_error("Could not create run file " + path);
+    }
+    T *outBuf = space + (size_t)chunk * n;
+    int outLen = 0;
+    while (!heads.empty()){
+        int i = heads.top();
+        heads.pop();
+        outBuf[outLen] = sources[i].buf[sources[i].pos];
+        outLen++;
+        if (outLen == chunk){
+            fwrite(outBuf, sizeof(T), outLen, out);
+            m_written += outLen;
+            outLen = 0;
+        }
+        if (advance(sources[i])){
+            heads.push(i);
+        }
+    }
+    fwrite(outBuf, sizeof(T), outLen, out);
+    m_written += outLen;
+    bool failed = ferror(out) != 0;
+    fclose(out);
+
+    for (int i=0; i < n; i++){
+        fclose(sources[i].file);
+    }
+    // if the merged run is bad keep the old runs
+    if (failed){
+        remove(path.c_str());
+        throw runtime_error("Could not write run file " + path);
+    }
+    for (int i=0; i < n; i++){
+        remove(m_runs[first + i].c_str());
+    }
+    int level = m_levels[first] + 1;
+    m_runs.erase(m_runs.begin() + first, m_runs.begin() + last);
+    m_levels.erase(m_levels.begin() + first, m_levels.begin() + last);
+    m_runs.push_back(path);
+    m_levels.push_back(level);
+}
+
+// returns nearest rank of quantile q, clamped to 1 to size()
+template <typename T>
+long long ExternalMedian<T>::rankFor(double q) {
+    if (q < 0 || q > 1){
+        throw out_of_range("Quantile must be from 0 to 1.");
+    }
+    long long k = (long long)(q * m_size);
+    if (k < q * m_size){
+        k++;
+    }
+    if (k < 1){
+        k = 1;
+    }
+    return k;
+}
+
+// returns a copy of the median
+template <typename T>
+T ExternalMedian<T>::getMedian() {
+    if (m_size == 0){
+        throw out_of_range("The ExternalMedian is empty.");
+    }
+    return select((m_size + 1) / 2);
+}
+
+// returns a copy of the q quantile
+template <typename T>
+T ExternalMedian<T>::getQuantile(double q) {
+    if (m_size == 0){
+        throw out_of_range("The ExternalMedian is empty.");
+    }
+    return select(rankFor(q));
+}
+
+// returns a copy of the k-th smallest item
+template <typename T>
+T ExternalMedian<T>::select(long long k) {
+    if (k < 1 || k > m_size){
+        throw out_of_range("Rank specified is invalid or out of range.");
+    }
+    T result;
+    selectRanks(&k, 1, &result);
+    return result;
+}
+
+// finds count quantiles in one merge
+template <typename T>
+void ExternalMedian<T>::quantiles(const double* qs, int count, T* out) {
+    if (m_size == 0){
+        throw out_of_range("The ExternalMedian is empty.");
+    }
+    if (count <= 0){
+        return;
+    }
+    vector<long long> ranks(count);
+    for (int i=0; i < count; i++){
+        ranks[i] = rankFor(qs[i]);
+    }
+    selectRanks(&ranks[0], count, out);
+}
+
+// merges every run and the sorted buffer in one sequential pass, copying the
+// item at each rank into out, and stops once the largest rank is reached
+template <typename T>
+void ExternalMedian<T>::selectRanks(const long long* ranks, int count, T* out) {
+    // visit ranks smallest first
+    vector<int> order(count);
+    for (int i=0; i < count; i++){
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [ranks](int a, int b) { return ranks[a] < ranks[b]; });
+
+    sort(m_buffer, m_buffer + m_bufSize, less);
+    int n = (int)m_runs.size();
+    int chunk = m_memItems / (n + 1);
+    if (chunk < 1){
+        chunk = 1;
+    }
+    T *space = new T[(size_t)chunk * (n + 1)];
+
+    vector<Source> sources(n + 1);
+    HeadAfter after;
+    after.sources = &sources;
+    after.less = less;
+    priority_queue<int, vector<int>, HeadAfter> heads(after);
+    for (int i=0; i < n; i++){
+        Source& s = sources[i];
+        s.file = fopen(m_runs[i].c_str(), "rb");
+        if (s.file == NULL){
+            for (int j=0; j < i; j++){
+                fclose(sources[j].file);
+            }
+            delete[] space;
+            throw runtime_error("Could not open run file " + m_runs[i]);
+        }
+        s.buf = space + (size_t)chunk * i;
+        s.cap = chunk;
+        s.pos = -1;
+        s.len = 0;
+        if (advance(s)){
+            heads.push(i);
+        }
+    }
+    // sorted buffer is read in place
+    Source& mem = sources[n];
+    mem.file = NULL;
+    mem.buf = m_buffer;
+    mem.cap = m_bufSize;
+    mem.pos = 0;
+    mem.len = m_bufSize;
+    if (m_bufSize > 0){
+        heads.push(n);
+    }
+
+    int next = 0;   // index into order of next rank to fill
+    for (long long seen = 1; next < count; seen++){
+        int i = heads.top();
+        heads.pop();
+        while (next < count && ranks[order[next]] == seen){
+            out[order[next]] = sources[i].buf[sources[i].pos];
+            next++;
+        }
+        if (advance(sources[i])){
+            heads.push(i);
+        }
+    }
+
+    for (int i=0; i < n; i++){
+        fclose(sources[i].file);
+    }
+    delete[] space;
+}
+
+#endif
@@ -0,0 +1,321 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    GroupMedian.h
+*/
+
+#ifndef _GROUPMEDIAN_H_
+#define _GROUPMEDIAN_H_
+
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+using namespace std;
+
+const int GROUP_RADIX_BITS = 10;        // first pass splits rows into up to 2^bits partitions
+const int GROUP_MIN_CHUNK = 1 << 16;    // fewest rows worth giving a thread
+
+// GroupMedian finds the median or quantiles of every group in a batch given
+// as two columns, groups[i] and values[i] for each row i. Group ids go from 0
+// to numGroups-1. Rather than one MedianHeap per group, rows are put in group
+// order in two radix passes. The first splits rows by the high bits of their
+// group into at most 2^GROUP_RADIX_BITS partitions, so each thread writes to
+// few enough places to stay in cache. The second takes one partition at a time
+// and sorts its rows by the rest of the group bits, after which each group's
+// values sit together and nth_element finds its ranks. Scratch memory is kept
+// between calls and only grows, so a steady batch size stops allocating.
+// Quantiles use the nearest rank and medians the lower middle, same as
+// MedianHeap. A group with no rows gets a count of 0 and its out is unchanged.
+template <typename T>
+class GroupMedian {
+public:
+    // constructor for GroupMedian class, threads of 0 or less uses every core
+    GroupMedian( bool (*lt) (const T&, const T&), int threads=0 ) ;
+
+    // out[g] gets the median of group g, counts[g] its rows if counts isn't NULL
+    void medians(const int* groups, const T* values, long long n, int numGroups,
+                 T* out, long long* counts=NULL) ;
+
+    // out[g*count + j] gets the qs[j] quantile of group g
+    void quantiles(const int* groups, const T* values, long long n, int numGroups,
+                   const double* qs, int count, T* out, long long* counts=NULL) ;
+
+    // returns the bytes of scratch memory held between calls
+    long long scratchBytes() ;
+
+private:
+    GroupMedian(const GroupMedian<T>& other);   // not copyable
+    const GroupMedian<T>& operator=(const GroupMedian<T>& rhs);
+
+    void countRows(int t, long long begin, long long end) ;     // partition counts of rows
+    void scatterRows(int t, long long begin, long long end) ;   // copies rows to their partitions
+    void finishPartitions(int t) ;  // sorts partitions by group and selects until none are left
+    void selectGroup(T* first, long long size, T* out) ;    // finds every rank of one group
+    long long rankFor(double q, long long size) ;   // nearest rank of q in size items
+
+    // arguments of the current call
+    const int *m_groups;
+    const T *m_values;
+    long long m_n;
+    int m_numGroups;
+    const double *m_qs;
+    int m_count;
+    T *m_out;
+    long long *m_countsOut;
+
+    int m_shift;    // group >> m_shift is its partition
+    int m_parts;    // number of partitions
+    int m_used;     // threads used by the current call
+    atomic<int> m_next; // next partition to finish
+
+    // scratch kept between calls
+    vector<int> m_partGroups;   // groups after the first pass
+    vector<T> m_partValues;     // values after the first pass
+    vector<T> m_sorted;         // values in group order
+    vector<long long> m_hist;   // rows of each partition seen by each thread
+    vector<long long> m_partStart;  // first row of each partition
+    vector< vector<long long> > m_local;    // each thread's group counts in a partition
+    vector<char> m_bad;     // true if a thread saw a group out of range
+    vector<int> m_order;    // quantiles sorted by q
+
+    int m_threads;
+    bool (*less) (const T&, const T&);
+};
+
+// constructor for GroupMedian class, scratch starts empty
+template <typename T>
+GroupMedian<T>::GroupMedian( bool (*lt) (const T&, const T&), int threads ) {
+    if (threads <= 0){
+        threads = (int)thread::hardware_concurrency();
+    }
+    m_threads = max(threads, 1);
+    m_local.resize(m_threads);
+    less = lt;
+}
+
+// returns bytes held by every scratch array
+template <typename T>
+long long GroupMedian<T>::scratchBytes() {
+    long long bytes = m_partGroups.capacity() * sizeof(int)
+                    + (m_partValues.capacity() + m_sorted.capacity()) * sizeof(T)
+                    + (m_hist.capacity() + m_partStart.capacity()) * sizeof(long long);
+    for (size_t i=0; i < m_local.size(); i++){
+        bytes += m_local[i].capacity() * sizeof(long long);
+    }
+    return bytes;
+}
+
+// returns the smallest k with k/size at least q, and at least 1
+template <typename T>
+long long GroupMedian<T>::rankFor(double q, long long size) {
+    long long k = (long long)(q * size);
+    if (k < q * size){
+        k++;
+    }
+    return k < 1 ? 1 : k;
+}
+
+// finds the median of each group, which is its 0.5 quantile
+template <typename T>
+void GroupMedian<T>::medians(const int* groups, const T* values, long long n, int numGroups,
+                             T* out, long long* counts) {
+    double half = 0.5;
+    quantiles(groups, values, n, numGroups, &half, 1, out, counts);
+}
+
+// counts how many rows from begin to end-1 fall in each partition
+template <typename T>
+void GroupMedian<T>::countRows(int t, long long begin, long long end) {
+    vector<long long> local(m_parts, 0);
+    bool bad = false;
+    for (long long i = begin; i < end; i++){
+        unsigned int g = (unsigned int)m_groups[i];
+        if (g >= (unsigned int)m_numGroups){
+            bad = true;
+            continue;
+        }
+        local[g >> m_shift]++;
+    }
+    copy(local.begin(), local.end(), m_hist.begin() + (long long)t * m_parts);
+    m_bad[t] = bad;
+}
+
+// copies rows from begin to end-1 after the rows earlier threads put in each
+// partition, m_hist row t already holds where this thread starts
+template <typename T>
+void GroupMedian<T>::scatterRows(int t, long long begin, long long end) {
+    vector<long long> next(m_hist.begin() + (long long)t * m_parts, m_hist.begin() + (long long)(t + 1) * m_parts);
+    for (long long i = begin; i < end; i++){
+        int g = m_groups[i];
+        long long at = next[g >> m_shift]++;
+        m_partGroups[at] = g;
+        m_partValues[at] = m_values[i];
+    }
+}
+
+// finds the count ranks of one group, each nth_element only looks at the
+// items from the previous rank up
+template <typename T>
+void GroupMedian<T>::selectGroup(T* first, long long size, T* out) {
+    T *from = first;
+    for (int i=0; i < m_count; i++){
+        int j = m_order[i];
+        T *at = first + rankFor(m_qs[j], size) - 1;
+        if (at != from || i == 0){
+            nth_element(from, at, first + size, less);
+        }
+        out[j] = *at;
+        from = at;
+    }
+}
+
+// takes partitions off m_next, counting-sorts each by group into m_sorted
+// then selects every group in it. Partitions don't share rows or groups
+template <typename T>
+void GroupMedian<T>::finishPartitions(int t) {
+    vector<long long>& local = m_local[t];
+    long long width = 1LL << m_shift;
+    local.resize(width + 1);
+    for (int p = m_next++; p < m_parts; p = m_next++){
+        long long begin = m_partStart[p];
+        long long end = m_partStart[p + 1];
+        long long base = (long long)p << m_shift;   // first group in partition
+        int groups = (int)min(width, (long long)m_numGroups - base);
+
+        fill(local.begin(), local.begin() + groups + 1, 0);
+        for (long long i = begin; i < end; i++){
+            local[m_partGroups[i] - base + 1]++;
+        }
+        for (int g=0; g < groups; g++){
+            local[g + 1] += local[g];
+        }
+        for (long long i = begin; i < end; i++){
+            m_sorted[begin + local[m_partGroups[i] - base]++] = m_partValues[i];
+        }
+
+        // local[g] is now where group g ends, counting from begin
+        long long start = begin;
+        for (int g=0; g < groups; g++){
+            long long size = begin + local[g] - start;
+            if (m_countsOut != NULL){
+                m_countsOut[base + g] = size;
+            }
+            if (size > 0){
+                selectGroup(&m_sorted[start], size, m_out + (base + g) * m_count);
+            }
+            start += size;
+        }
+    }
+}
+
+// partitions rows by group in two passes, then selects each group
+template <typename T>
+void GroupMedian<T>::quantiles(const int* groups, const T* values, long long n, int numGroups,
+                               const double* qs, int count, T* out, long long* counts) {
+    if (numGroups < 1){
+        throw out_of_range("There must be at least one group.");
+    }
+    for (int j=0; j < count; j++){
+        if (qs[j] < 0 || qs[j] > 1){
+            throw out_of_range("Quantile must be from 0 to 1.");
+        }
+    }
+    m_groups = groups;
+    m_values = values;
+    m_n = n;
+    m_numGroups = numGroups;
+    m_qs = qs;
+    m_count = count;
+    m_out = out;
+    m_countsOut = counts;
+
+    // ranks grow with q, so sorting q lets each group's ranks be found in order
+    m_order.resize(count);
+    for (int j=0; j < count; j++){
+        m_order[j] = j;
+    }
+    for (int i=1; i < count; i++){
+        int j = m_order[i];
+        int k = i;
+        for (; k > 0 && qs[m_order[k - 1]] > qs[j]; k--){
+            m_order[k] = m_order[k - 1];
+        }
+        m_order[k] = j;
+    }
+
+    // high bits pick the partition, the rest are sorted within it
+    int bits = 0;
+    while ((1LL << bits) < numGroups){
+        bits++;
+    }
+    m_shift = max(bits - GROUP_RADIX_BITS, 0);
+    m_parts = (int)((numGroups - 1) >> m_shift) + 1;
+
+    // don't start threads that would each get a tiny chunk
+    m_used = (int)max(1LL, min((long long)m_threads, n / GROUP_MIN_CHUNK));
+    long long chunk = (n + m_used - 1) / m_used;
+    if (chunk == 0){
+        chunk = 1;
+    }
+    if ((long long)m_partValues.size() < n){
+        m_partGroups.resize(n);
+        m_partValues.resize(n);
+        m_sorted.resize(n);
+    }
+    m_hist.resize((long long)m_used * m_parts);
+    m_partStart.resize(m_parts + 1);
+    m_bad.assign(m_used, 0);
+
+    vector<thread> workers;
+    for (int t=1; t < m_used; t++){
+        workers.push_back(thread(&GroupMedian<T>::countRows, this, t, min(n, t * chunk), min(n, (t + 1) * chunk)));
+    }
+    // this thread does the first chunk
+    countRows(0, 0, min(n, chunk));
+    for (size_t i=0; i < workers.size(); i++){
+        workers[i].join();
+    }
+    for (int t=0; t < m_used; t++){
+        if (m_bad[t]){
+            throw out_of_range("Group id is invalid or out of range.");
+        }
+    }
+
+    // turns counts into where each thread starts in each partition
+    long long at = 0;
+    for (int p=0; p < m_parts; p++){
+        m_partStart[p] = at;
+        for (int t=0; t < m_used; t++){
+            long long rows = m_hist[(long long)t * m_parts + p];
+            m_hist[(long long)t * m_parts + p] = at;
+            at += rows;
+        }
+    }
+    m_partStart[m_parts] = at;
+
+    workers.clear();
+    for (int t=1; t < m_used; t++){
+        workers.push_back(thread(&GroupMedian<T>::scatterRows, this, t, min(n, t * chunk), min(n, (t + 1) * chunk)));
+    }
+    scatterRows(0, 0, min(n, chunk));
+    for (size_t i=0; i < workers.size(); i++){
+        workers[i].join();
+    }
+
+    // partitions are uneven, so threads take the next one when they finish
+    m_next = 0;
+    workers.clear();
+    for (int t=1; t < m_used; t++){
+        workers.push_back(thread(&GroupMedian<T>::finishPartitions, this, t));
+    }
+    finishPartitions(0);
+    for (size_t i=0; i < workers.size(); i++){
+        workers[i].join();
+    }
+}
+
+#endif
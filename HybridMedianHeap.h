@@ -0,0 +1,313 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    HybridMedianHeap.h
+*/
+
+#ifndef _HYBRIDMEDIANHEAP_H_
+#define _HYBRIDMEDIANHEAP_H_
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include "MedianHeap.h"
+using namespace std;
+
+// HybridMedianHeap holds small sets of items in a sorted array stored inside
+// the object, where the median is just the middle index and an insert is a
+// binary search plus a shift that copy_backward turns into a memmove for
+// plain types. Once it holds more than threshold items it moves them into a
+// MedianHeap, and it moves back to the array when it shrinks below half the
+// threshold, so a size hovering at the threshold doesn't convert every op.
+template <typename T, int SMALL = 64>
+class HybridMedianHeap {
+public:
+    // constructor for HybridMedianHeap class
+    // threshold is the most items kept in the sorted array, at most SMALL
+    HybridMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap=100, int threshold=SMALL ) ;
+
+    // copy constructor
+    HybridMedianHeap(const HybridMedianHeap<T, SMALL>& otherH) ;
+
+    // destructor
+    ~HybridMedianHeap() ;
+
+    // overloaded assignment operator
+    const HybridMedianHeap<T, SMALL>& operator=(const HybridMedianHeap<T, SMALL>& rhs) ;
+
+    // returns the total number of items in the HybridMedianHeap
+    int size() ;
+
+    // returns the maximum number of items that can be stored in the HybridMedianHeap
+    int capacity() ;
+
+    // returns true if items are in the sorted array, false if in the heaps
+    bool isSmall() ;
+
+    // adds the item given in the parameter to the HybridMedianHeap
+    void insert(const T& item) ;
+
+    // returns a copy of the median key object
+    T getMedian() ;
+
+    // returns a copy of the minimum key object
+    T getMin() ;
+
+    // returns a copy of the maximum key object
+    T getMax() ;
+
+    // deletes specified item from HybridMedianHeap, returns true if found and false if unfound
+    bool deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) ;
+
+    // prints out the contents of the HybridMedianHeap
+    void dump() ;
+
+private:
+    static bool always(const T&) { return true; }   // matches every item
+
+    void toHeaps();     // moves sorted array into the MedianHeap
+    void toSmall();     // moves MedianHeap items back into the sorted array
+
+    T m_small[SMALL];   // sorted items while small
+    int m_smallSize;    // number of items in m_small
+    MedianHeap<T> *m_heaps; // used once size passes threshold, kept for reuse
+    bool m_isSmall;     // true if m_small holds the items
+    int m_threshold;    // most items kept in m_small
+    int m_capacity;     // capacity of HybridMedianHeap
+
+    bool (*less) (const T&, const T&);
+    bool (*greater) (const T&, const T&);
+};
+
+// constructor for HybridMedianHeap class
+// starts out small, MedianHeap isn't created until it is needed
+template <typename T, int SMALL>
+HybridMedianHeap<T, SMALL>::HybridMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap, int threshold) {
+    if (threshold < 1 || threshold > SMALL){
+        throw out_of_range("Threshold is invalid or out of range.");
+    }
+    m_capacity = cap;
+    m_threshold = threshold;
+    m_smallSize = 0;
+    m_heaps = NULL;
+    m_isSmall = true;
+    less = lt;
+    greater = gt;
+}
+
+// HybridMedianHeap class copy constructor
+// creates a deep copy of the passed in HybridMedianHeap object
+template <typename T, int SMALL>
+HybridMedianHeap<T, SMALL>::HybridMedianHeap(const HybridMedianHeap<T, SMALL>& otherH) {
+    m_capacity = otherH.m_capacity;
+    m_threshold = otherH.m_threshold;
+    m_smallSize = otherH.m_smallSize;
+    m_isSmall = otherH.m_isSmall;
+    less = otherH.less;
+    greater = otherH.greater;
+    for (int i=0; i < m_smallSize; i++){
+        m_small[i] = otherH.m_small[i];
+    }
+    m_heaps = NULL;
+    if (otherH.m_heaps != NULL){
+        m_heaps = new MedianHeap<T>(*(otherH.m_heaps));
+    }
+}
+
+// HybridMedianHeap class destructor
+template <typename T, int SMALL>
+HybridMedianHeap<T, SMALL>::~HybridMedianHeap() {
+    delete m_heaps;
+    m_heaps = NULL;
+    m_smallSize = 0;
+    m_capacity = 0;
+}
+
+// HybridMedianHeap class overloaded assignment operator
+// deallocates memory of the host object and copies rhs into host
+template <typename T, int SMALL>
+const HybridMedianHeap<T, SMALL>& HybridMedianHeap<T, SMALL>::operator=(const HybridMedianHeap<T, SMALL>& rhs) {
+    // checks first for self-assignment, if true returns object
+    if(this == &rhs){
+        return *this;
+    }
+    m_capacity = rhs.m_capacity;
+    m_threshold = rhs.m_threshold;
+    m_smallSize = rhs.m_smallSize;
+    m_isSmall = rhs.m_isSmall;
+    less = rhs.less;
+    greater = rhs.greater;
+    for (int i=0; i < m_smallSize; i++){
+        m_small[i] = rhs.m_small[i];
+    }
+    delete m_heaps;
+    m_heaps = NULL;
+    if (rhs.m_heaps != NULL){
+        m_heaps = new MedianHeap<T>(*(rhs.m_heaps));
+    }
+    return *this;
+}
+
+// returns the total number of items in the HybridMedianHeap
+template <typename T, int SMALL>
+int HybridMedianHeap<T, SMALL>::size() {
+    return m_isSmall ? m_smallSize : m_heaps->size();
+}
+
+// returns the maximum number of items that can be stored in the HybridMedianHeap
+template <typename T, int SMALL>
+int HybridMedianHeap<T, SMALL>::capacity() {
+    return m_capacity;
+}
+
+// returns true if items are in the sorted array
+template <typename T, int SMALL>
+bool HybridMedianHeap<T, SMALL>::isSmall() {
+    return m_isSmall;
+}
+
+// moves every item into the MedianHeap, creating it the first time
+template <typename T, int SMALL>
+void HybridMedianHeap<T, SMALL>::toHeaps() {
+    if (m_heaps == NULL){
+        m_heaps = new MedianHeap<T>(less, greater, m_capacity);
+    }
+    // inserting from the middle out keeps each insert near the median
+    int mid = (m_smallSize - 1) / 2;
+    m_heaps->insert(m_small[mid]);
+    for (int i=1; mid - i >= 0 || mid + i < m_smallSize; i++){
+        if (mid + i < m_smallSize){
+            m_heaps->insert(m_small[mid + i]);
+        }
+        if (mid - i >= 0){
+            m_heaps->insert(m_small[mid - i]);
+        }
+    }
+    m_smallSize = 0;
+    m_isSmall = false;
+}
+
+// copies items out of both heaps, sorts them and empties the MedianHeap
+template <typename T, int SMALL>
+void HybridMedianHeap<T, SMALL>::toSmall() {
+    m_smallSize = 0;
+    for (int i=1; i <= m_heaps->maxHeapSize(); i++){
+        m_small[m_smallSize++] = m_heaps->locateInMaxHeap(i);
+    }
+    for (int i=1; i <= m_heaps->minHeapSize(); i++){
+        m_small[m_smallSize++] = m_heaps->locateInMinHeap(i);
+    }
+    sort(m_small, m_small + m_smallSize, less);
+    m_heaps->deleteMany(always);
+    m_isSmall = true;
+}
+
+// adds item to sorted array after every item it isn't less than, or to the heaps
+template <typename T, int SMALL>
+void HybridMedianHeap<T, SMALL>::insert(const T& item) {
+    // if HybridMedianHeap is full throw out of range error
+    if(size() == capacity()){
+        throw out_of_range("The HybridMedianHeap is full. Cannot insert item.");
+    }
+    if (m_isSmall && m_smallSize == m_threshold){
+        toHeaps();
+    }
+    if (!m_isSmall){
+        m_heaps->insert(item);
+        return;
+    }
+    T *pos = upper_bound(m_small, m_small + m_smallSize, item, less);
+    copy_backward(pos, m_small + m_smallSize, m_small + m_smallSize + 1);
+    *pos = item;
+    m_smallSize++;
+}
+
+// returns a copy of the median key object
+// for an even number of items this is the lower middle, same as MedianHeap
+template <typename T, int SMALL>
+T HybridMedianHeap<T, SMALL>::getMedian() {
+    if(size() == 0){
+        throw out_of_range("The HybridMedianHeap is empty.");
+    }
+    if (!m_isSmall){
+        return m_heaps->getMedian();
+    }
+    return m_small[(m_smallSize - 1) / 2];
+}
+
+// returns a copy of the min key object
+template <typename T, int SMALL>
+T HybridMedianHeap<T, SMALL>::getMin() {
+    if(size() == 0){
+        throw out_of_range("The HybridMedianHeap is empty.");
+    }
+    if (!m_isSmall){
+        return m_heaps->getMin();
+    }
+    return m_small[0];
+}
+
+// returns a copy of the max key object
+template <typename T, int SMALL>
+T HybridMedianHeap<T, SMALL>::getMax() {
+    if(size() == 0){
+        throw out_of_range("The HybridMedianHeap is empty.");
+    }
+    if (!m_isSmall){
+        return m_heaps->getMax();
+    }
+    return m_small[m_smallSize - 1];
+}
+
+// looks for givenItem and if found deletes item and returns true
+// if unfound, HybridMedianHeap is unchanged and returns false
+template <typename T, int SMALL>
+bool HybridMedianHeap<T, SMALL>::deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) {
+    // if the HybridMedianHeap is empty throw out of range error
+    if(size() == 0) {
+        throw out_of_range("The heap is empty, cannot remove item.");
+    }
+    if (!m_isSmall){
+        bool found = m_heaps->deleteItem(givenItem, equalTo);
+        if (found && m_heaps->size() < m_threshold / 2){
+            toSmall();
+        }
+        return found;
+    }
+    // equalTo may not agree with less, so check every item like MedianHeap does
+    for (int i=0; i < m_smallSize; i++){
+        if (equalTo(m_small[i], givenItem)){
+            givenItem = m_small[i];
+            copy(m_small + i + 1, m_small + m_smallSize, m_small + i);
+            m_smallSize--;
+            return true;
+        }
+    }
+    return false;
+}
+
+// prints out sorted array, or the heaps if it has converted
+template <typename T, int SMALL>
+void HybridMedianHeap<T, SMALL>::dump() {
+    if (!m_isSmall){
+        m_heaps->dump();
+        return;
+    }
+    cout << "... HybridMedianHeap()::dump() ..." << endl;
+    cout << endl;
+    cout << "size = " << m_smallSize << ", ";
+    cout << "threshold = " << m_threshold << endl;
+    for (int i=0; i < m_smallSize; i++){
+        cout << "Array[" << i << "] = (" << m_small[i] << ")" << endl;
+    }
+    cout << "--------------------------------" << endl;
+    if (m_smallSize > 0){
+        cout << "min    = " << getMin() << endl;
+        cout << "median = " << getMedian() << endl;
+        cout << "max    = " << getMax() << endl;
+    }
+}
+
+#endif
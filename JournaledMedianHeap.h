@@ -0,0 +1,598 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    JournaledMedianHeap.h
+*/
+
+#ifndef _JOURNALEDMEDIANHEAP_H_
+#define _JOURNALEDMEDIANHEAP_H_
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "MedianHeap.h"
+using namespace std;
+
+const unsigned int JOURNAL_BATCH_MAGIC = 0x4a4d4842;   // starts every batch in the log
+const unsigned int JOURNAL_BASE_MAGIC = 0x4a4d4849;    // starts a base image
+const char JOURNAL_INSERT = 1;  // op codes of log records
+const char JOURNAL_DELETE = 2;
+
+// JournaledMedianHeap is a MedianHeap that survives a crash without writing
+// out every item after each change. Each insert and deleteItem that changes
+// the heap is appended to a log at path.log as one record, an op byte and
+// the item's raw bytes. Records are grouped, groupSize at a time or on
+// commit(), into batches that carry their first op number and a checksum,
+// and each batch is written and synced as a single append. A crash loses at
+// most the ops of the batch not yet committed. The log is written with raw
+// write() calls on its descriptor, so nothing is left buffered after a
+// failed write to land ahead of the retried batch.
+//
+// Once the log holds more ops than the heap holds items, and at least
+// compactOps of them, it is compacted: both heap arrays are written whole to
+// path.base, renamed over the old image, and the log starts over. Each item
+// is then written about twice, once in the log and once in a base image.
+// Opening a path that already has files recovers it by reading the base
+// image straight into the heap arrays and replaying the log after it. A torn
+// or damaged batch ends the log and is cut off. Ops the base image already
+// holds are skipped, so a crash between the rename and the log starting over
+// is safe. T is written to disk as raw bytes, so it must be trivially
+// copyable. Deletes are replayed with the same equalTo given here.
+template <typename T>
+class JournaledMedianHeap {
+    static_assert(is_trivially_copyable<T>::value, "JournaledMedianHeap needs a trivially copyable type");
+public:
+    // constructor for JournaledMedianHeap class, recovers path if it has files
+    // must create a JournaledMedianHeap object capable of holding cap items
+    JournaledMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&),
+                         bool (*eq) (const T&, const T&), const string& path, int cap=100,
+                         int groupSize=64, long long compactOps=1<<16, bool sync=true ) ;
+
+    // destructor, commits any ops still waiting
+    ~JournaledMedianHeap() ;
+
+    // returns the total number of items in the JournaledMedianHeap
+    int size() ;
+
+    // returns the maximum number of items that can be stored
+    int capacity() ;
+
+    // adds the item given in the parameter and logs it
+    void insert(const T& item) ;
+
+    // deletes an item equalTo givenItem and logs it, returns true if found
+    bool deleteItem(T& givenItem) ;
+
+    // returns true if the log write or compaction started by the last full
+    // batch failed. The ops were still done and stay pending until a commit
+    // gets them into the log, insert and deleteItem never throw for it
+    bool logFailed() ;
+
+    // returns a copy of the median key object
+    T getMedian() ;
+
+    // returns a copy of the minimum key object
+    T getMin() ;
+
+    // returns a copy of the maximum key object
+    T getMax() ;
+
+    // writes and syncs every op not yet in the log
+    void commit() ;
+
+    // writes a new base image and starts the log over
+    void checkpoint() ;
+
+    // returns the number of ops not yet committed
+    int pending() ;
+
+    // returns the number of ops replayed when the heap was opened
+    long long replayed() ;
+
+    // returns the number of ops logged since the heap was opened
+    long long opsLogged() ;
+
+    // returns the bytes appended to the log since the heap was opened
+    long long logBytes() ;
+
+    // returns the bytes written to base images since the heap was opened
+    long long baseBytes() ;
+
+    // prints out the heap and the state of the log
+    void dump() ;
+
+private:
+    JournaledMedianHeap(const JournaledMedianHeap<T>& other);   // not copyable
+    const JournaledMedianHeap<T>& operator=(const JournaledMedianHeap<T>& rhs);
+
+    // written before the records of each batch
+    struct BatchHeader {
+        unsigned int magic;
+        unsigned int count;     // records in batch
+        long long firstLsn;     // op number of the first record
+        unsigned int checksum;  // of the records
+        unsigned int unused;
+    };
+
+    // written before the items of a base image
+    struct BaseHeader {
+        unsigned int magic;
+        int itemBytes;      // sizeof(T) when written
+        long long lsn;      // ops the image holds
+        int lowerSize;      // items in max heap
+        int upperSize;      // items in min heap
+        unsigned int checksum;  // of min, max and both arrays
+        unsigned int unused;
+    };
+
+    void record(char op, const T& item) ;   // adds one op to the batch
+    void recover() ;        // loads the base image and replays the log
+    bool loadBase() ;       // reads path.base into the heap, false if there is none
+    void replayLog() ;      // applies the log's ops after the base image
+    void apply(char op, const T& item) ;    // redoes one op from the log
+    void writeBase() ;      // writes the heap to a new base image
+    void openLog(int flags) ;   // opens path.log for appending with flags added
+    void writeLog(const char *data, size_t bytes, bool& failed) ;  // appends to the log
+    void syncDir() ;        // makes a rename in the log's directory durable
+    static unsigned int checksum(const char *data, size_t bytes, unsigned int hash) ;
+
+    MedianHeap<T> m_heap;
+    string m_basePath;  // path.base
+    string m_logPath;   // path.log
+    int m_log;          // descriptor open for appending, -1 if not open
+    long long m_logLength;  // bytes of whole batches in the log
+
+    vector<char> m_batch;   // records not yet written
+    int m_batchOps;     // records in m_batch
+    long long m_batchLsn;   // op number of first record in m_batch
+    long long m_lsn;    // op number the next op gets
+    long long m_logOps; // ops in the log and batch since the last base image
+    bool m_logFailed;   // last commit started by a full batch failed
+    bool m_torn;        // a failed write may have left bytes past m_logLength
+
+    int m_groupSize;
+    long long m_compactOps;
+    bool m_sync;
+    long long m_replayed;
+    long long m_opsLogged;
+    long long m_logBytes;
+    long long m_baseBytes;
+
+    bool (*equalTo) (const T&, const T&);
+};
+
+// constructor for JournaledMedianHeap class
+template <typename T>
+JournaledMedianHeap<T>::JournaledMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&),
+                                             bool (*eq) (const T&, const T&), const string& path, int cap,
+                                             int groupSize, long long compactOps, bool sync )
+    : m_heap(lt, gt, cap) {
+    if (groupSize < 1){
+        throw out_of_range("groupSize must be at least one.");
+    }
+    m_basePath = path + ".base";
+    m_logPath = path + ".log";
+    m_log = -1;
+    m_logLength = 0;
+    m_batchOps = 0;
+    m_batchLsn = 0;
+    m_lsn = 0;
+    m_logOps = 0;
+    m_logFailed = false;
+    m_torn = false;
+    m_groupSize = groupSize;
+    m_compactOps = compactOps;
+    m_sync = sync;
+    m_replayed = 0;
+    m_opsLogged = 0;
+    m_logBytes = 0;
+    m_baseBytes = 0;
+    equalTo = eq;
+    recover();
+}
+
+// JournaledMedianHeap class destructor
+// commits what is left, a failed write loses only those ops
+template <typename T>
+JournaledMedianHeap<T>::~JournaledMedianHeap() {
+    try {
+        commit();
+    }
+    catch (...) {
+    }
+    if (m_log >= 0){
+        close(m_log);
+        m_log = -1;
+    }
+}
+
+// returns the total number of items
+template <typename T>
+int JournaledMedianHeap<T>::size() {
+    return m_heap.size();
+}
+
+// returns the maximum number of items that can be stored
+template <typename T>
+int JournaledMedianHeap<T>::capacity() {
+    return m_heap.capacity();
+}
+
+// returns a copy of the median
+template <typename T>
+T JournaledMedianHeap<T>::getMedian() {
+    return m_heap.getMedian();
+}
+
+// returns a copy of the min
+template <typename T>
+T JournaledMedianHeap<T>::getMin() {
+    return m_heap.getMin();
+}
+
+// returns a copy of the max
+template <typename T>
+T JournaledMedianHeap<T>::getMax() {
+    return m_heap.getMax();
+}
+
+// returns the number of ops not yet committed
+template <typename T>
+int JournaledMedianHeap<T>::pending() {
+    return m_batchOps;
+}
+
+// returns true if the last commit started by a full batch failed
+template <typename T>
+bool JournaledMedianHeap<T>::logFailed() {
+    return m_logFailed;
+}
+
+// returns the number of ops replayed on opening
+template <typename T>
+long long JournaledMedianHeap<T>::replayed() {
+    return m_replayed;
+}
+
+// returns the number of ops logged since opening
+template <typename T>
+long long JournaledMedianHeap<T>::opsLogged() {
+    return m_opsLogged;
+}
+
+// returns the bytes appended to the log since opening
+template <typename T>
+long long JournaledMedianHeap<T>::logBytes() {
+    return m_logBytes;
+}
+
+// returns the bytes written to base images since opening
+template <typename T>
+long long JournaledMedianHeap<T>::baseBytes() {
+    return m_baseBytes;
+}
+
+// FNV-1a hash of bytes, continuing from hash
+template <typename T>
+unsigned int JournaledMedianHeap<T>::checksum(const char *data, size_t bytes, unsigned int hash) {
+    for (size_t i=0; i < bytes; i++){
+        hash = (hash ^ (unsigned char)data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// inserts item, the heap throws if full and then nothing is logged
+// a failed log write doesn't throw, see logFailed()
+template <typename T>
+void JournaledMedianHeap<T>::insert(const T& item) {
+    m_heap.insert(item);
+    record(JOURNAL_INSERT, item);
+}
+
+// logs the item as given, so a replay matches the same item it did
+// a failed log write doesn't throw, see logFailed()
+template <typename T>
+bool JournaledMedianHeap<T>::deleteItem(T& givenItem) {
+    T given = givenItem;
+    bool found = m_heap.deleteItem(givenItem, equalTo);
+    if (found){
+        record(JOURNAL_DELETE, given);
+    }
+    return found;
+}
+
+// appends a record to the batch, committing once it holds groupSize
+template <typename T>
+void JournaledMedianHeap<T>::record(char op, const T& item) {
+    if (m_batchOps == 0){
+        m_batchLsn = m_lsn;
+    }
+    size_t at = m_batch.size();
+    m_batch.resize(at + 1 + sizeof(T));
+    m_batch[at] = op;
+    memcpy(&m_batch[at + 1], &item, sizeof(T));
+    m_batchOps++;
+    m_lsn++;
+    m_logOps++;
+    m_opsLogged++;
+    // the op is already done, so throwing would tell the caller it wasn't and
+    // a retry would do it twice. The batch is kept and logFailed() reports it
+    if (m_batchOps >= m_groupSize){
+        try {
+            commit();
+        }
+        catch (const runtime_error&) {
+            m_logFailed = true;
+        }
+    }
+}
+
+// writes all of data to the end of the log, setting failed if it can't
+template <typename T>
+void JournaledMedianHeap<T>::writeLog(const char *data, size_t bytes, bool& failed) {
+    while (!failed && bytes > 0){
+        ssize_t wrote = write(m_log, data, bytes);
+        if (wrote < 0 && errno == EINTR){
+            continue;
+        }
+        if (wrote <= 0){
+            failed = true;
+            return;
+        }
+        data += wrote;
+        bytes -= (size_t)wrote;
+    }
+}
+
+// writes the batch as one append and syncs it. If the write fails the log
+// is cut back to its last whole batch and the batch is kept to try again
+template <typename T>
+void JournaledMedianHeap<T>::commit() {
+    if (m_batchOps == 0){
+        return;
+    }
+    BatchHeader header;
+    header.magic = JOURNAL_BATCH_MAGIC;
+    header.count = (unsigned int)m_batchOps;
+    header.firstLsn = m_batchLsn;
+    header.checksum = checksum(&m_batch[0], m_batch.size(), 2166136261u);
+    header.unused = 0;
+
+    // a batch appended after torn bytes would be cut off with them by recovery
+    if (m_torn){
+        if (ftruncate(m_log, m_logLength) != 0){
+            throw runtime_error("Could not cut back log " + m_logPath);
+        }
+        m_torn = false;
+    }
+    bool failed = false;
+    writeLog((const char*)&header, sizeof(header), failed);
+    writeLog(&m_batch[0], m_batch.size(), failed);
+    if (!failed && m_sync){
+        failed = fsync(m_log) != 0;
+    }
+    if (failed){
+        // the log is opened for appending, so the retry lands right after the
+        // cut. If the cut fails too, the next commit tries it again first
+        m_torn = ftruncate(m_log, m_logLength) != 0;
+        throw runtime_error("Could not write log " + m_logPath);
+    }
+    long long bytes = (long long)(sizeof(header) + m_batch.size());
+    m_logLength += bytes;
+    m_logBytes += bytes;
+    m_batch.clear();
+    m_batchOps = 0;
+    m_logFailed = false;
+
+    // compacting once the log outgrows the heap keeps both about the same size
+    if (m_logOps >= max(m_compactOps, (long long)size())){
+        checkpoint();
+    }
+}
+
+// commits, writes a new base image under a temporary name and renames it
+// over the old one, then starts the log over
+template <typename T>
+void JournaledMedianHeap<T>::checkpoint() {
+    commit();
+    writeBase();
+    close(m_log);
+    m_log = -1;
+    openLog(O_TRUNC);
+    m_torn = false;
+    if (m_sync && fsync(m_log) != 0){
+        throw runtime_error("Could not sync " + m_logPath);
+    }
+    m_logLength = 0;
+    m_logOps = 0;
+}
+
+// opens path.log for appending, creating it if it isn't there
+template <typename T>
+void JournaledMedianHeap<T>::openLog(int flags) {
+    m_log = open(m_logPath.c_str(), O_WRONLY | O_APPEND | O_CREAT | flags, 0644);
+    if (m_log < 0){
+        throw runtime_error("Could not open log " + m_logPath);
+    }
+}
+
+// syncs the directory holding the files so a rename in it is on disk
+template <typename T>
+void JournaledMedianHeap<T>::syncDir() {
+    if (!m_sync){
+        return;
+    }
+    size_t slash = m_basePath.rfind('/');
+    string dir = slash == string::npos ? "." : m_basePath.substr(0, slash + 1);
+    int fd = open(dir.c_str(), O_RDONLY);
+    if (fd >= 0){
+        fsync(fd);
+        close(fd);
+    }
+}
+
+// writes header, min, max and both heap arrays to path.base.tmp, syncs it
+// and renames it to path.base
+template <typename T>
+void JournaledMedianHeap<T>::writeBase() {
+    Heap<T> *lower = m_heap.maxHeap;
+    Heap<T> *upper = m_heap.minHeap;
+    BaseHeader header;
+    header.magic = JOURNAL_BASE_MAGIC;
+    header.itemBytes = (int)sizeof(T);
+    header.lsn = m_lsn;
+    header.lowerSize = lower->m_heapSize;
+    header.upperSize = upper->m_heapSize;
+    header.unused = 0;
+    unsigned int hash = checksum((const char*)&m_heap.m_min, sizeof(T), 2166136261u);
+    hash = checksum((const char*)&m_heap.m_max, sizeof(T), hash);
+    hash = checksum((const char*)(lower->m_heap + 1), sizeof(T) * lower->m_heapSize, hash);
+    header.checksum = checksum((const char*)(upper->m_heap + 1), sizeof(T) * upper->m_heapSize, hash);
+
+    string tmp = m_basePath + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    if (f == NULL){
+        throw runtime_error("Could not create base image " + tmp);
+    }
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(&m_heap.m_min, sizeof(T), 1, f);
+    fwrite(&m_heap.m_max, sizeof(T), 1, f);
+    fwrite(lower->m_heap + 1, sizeof(T), lower->m_heapSize, f);
+    fwrite(upper->m_heap + 1, sizeof(T), upper->m_heapSize, f);
+    bool failed = ferror(f) != 0 || fflush(f) != 0 || (m_sync && fsync(fileno(f)) != 0);
+    fclose(f);
+    if (failed || rename(tmp.c_str(), m_basePath.c_str()) != 0){
+        remove(tmp.c_str());
+        throw runtime_error("Could not write base image " + m_basePath);
+    }
+    syncDir();
+    m_baseBytes += (long long)(sizeof(header) + sizeof(T) * (2 + lower->m_heapSize + upper->m_heapSize));
+}
+
+// reads the base image, if there is one, straight into the heap arrays
+template <typename T>
+bool JournaledMedianHeap<T>::loadBase() {
+    FILE *f = fopen(m_basePath.c_str(), "rb");
+    if (f == NULL){
+        return false;
+    }
+    Heap<T> *lower = m_heap.maxHeap;
+    Heap<T> *upper = m_heap.minHeap;
+    BaseHeader header;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1
+           && header.magic == JOURNAL_BASE_MAGIC
+           && header.itemBytes == (int)sizeof(T)
+           && header.lowerSize >= 0 && header.lowerSize <= lower->m_heapCap
+           && header.upperSize >= 0 && header.upperSize <= upper->m_heapCap
+           && header.lowerSize + header.upperSize <= m_heap.capacity();
+    ok = ok && fread(&m_heap.m_min, sizeof(T), 1, f) == 1
+            && fread(&m_heap.m_max, sizeof(T), 1, f) == 1
+            && fread(lower->m_heap + 1, sizeof(T), header.lowerSize, f) == (size_t)header.lowerSize
+            && fread(upper->m_heap + 1, sizeof(T), header.upperSize, f) == (size_t)header.upperSize;
+    fclose(f);
+    if (ok){
+        unsigned int hash = checksum((const char*)&m_heap.m_min, sizeof(T), 2166136261u);
+        hash = checksum((const char*)&m_heap.m_max, sizeof(T), hash);
+        hash = checksum((const char*)(lower->m_heap + 1), sizeof(T) * header.lowerSize, hash);
+        ok = checksum((const char*)(upper->m_heap + 1), sizeof(T) * header.upperSize, hash) == header.checksum;
+    }
+    if (!ok){
+        throw runtime_error("Base image is damaged " + m_basePath);
+    }
+    // the arrays were written in heap order, only the sums need counting
+    lower->m_heapSize = header.lowerSize;
+    upper->m_heapSize = header.upperSize;
+    lower->m_sums.clear();
+    upper->m_sums.clear();
+    for (int i=1; i <= lower->m_heapSize; i++){
+        lower->m_sums.add(lower->m_heap[i]);
+    }
+    for (int i=1; i <= upper->m_heapSize; i++){
+        upper->m_sums.add(upper->m_heap[i]);
+    }
+    m_lsn = header.lsn;
+    return true;
+}
+
+// redoes one logged op, which must succeed as it did when it was logged
+template <typename T>
+void JournaledMedianHeap<T>::apply(char op, const T& item) {
+    if (op == JOURNAL_INSERT && size() < capacity()){
+        m_heap.insert(item);
+        return;
+    }
+    T given = item;
+    if (op != JOURNAL_DELETE || size() == 0 || !m_heap.deleteItem(given, equalTo)){
+        throw runtime_error("Log does not match base image " + m_logPath);
+    }
+}
+
+// applies each whole batch in the log in order, skipping ops the base image
+// already holds, and stops at the first torn, damaged or out of order batch
+template <typename T>
+void JournaledMedianHeap<T>::replayLog() {
+    FILE *f = fopen(m_logPath.c_str(), "rb");
+    if (f == NULL){
+        return;
+    }
+    const size_t recordBytes = 1 + sizeof(T);
+    vector<char> body;
+    BatchHeader header;
+    while (fread(&header, sizeof(header), 1, f) == 1){
+        if (header.magic != JOURNAL_BATCH_MAGIC || header.firstLsn > m_lsn){
+            break;
+        }
+        body.resize((size_t)header.count * recordBytes);
+        if (body.empty() || fread(&body[0], 1, body.size(), f) != body.size()
+            || checksum(&body[0], body.size(), 2166136261u) != header.checksum){
+            break;
+        }
+        for (unsigned int i=0; i < header.count; i++){
+            if (header.firstLsn + i < m_lsn){
+                continue;
+            }
+            T item;
+            memcpy(&item, &body[i * recordBytes + 1], sizeof(T));
+            apply(body[i * recordBytes], item);
+            m_lsn++;
+            m_logOps++;
+            m_replayed++;
+        }
+        m_logLength += (long long)(sizeof(header) + body.size());
+    }
+    fclose(f);
+    // anything after the last whole batch is cut off before appending
+    if (truncate(m_logPath.c_str(), m_logLength) != 0){
+        throw runtime_error("Could not truncate log " + m_logPath);
+    }
+}
+
+// loads path.base then replays path.log and opens it for appending
+template <typename T>
+void JournaledMedianHeap<T>::recover() {
+    loadBase();
+    replayLog();
+    openLog(0);
+}
+
+// prints out the heap followed by the state of the log
+template <typename T>
+void JournaledMedianHeap<T>::dump() {
+    m_heap.dump();
+    cout << "next op = " << m_lsn << ", ";
+    cout << "ops in log = " << m_logOps << ", ";
+    cout << "pending = " << m_batchOps;
+    cout << (m_logFailed ? ", last commit failed" : "") << endl;
+}
+
+#endif
@@ -0,0 +1,401 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    KeyedMedianHeap.h
+*/
+
+#ifndef _KEYEDMEDIANHEAP_H_
+#define _KEYEDMEDIANHEAP_H_
+
+#include <iostream>
+#include <stdexcept>
+#include "MedianHeap.h"
+using namespace std;
+
+// KeyedMedianHeap orders records by a small key, such as a latency field,
+// without moving the records. The heaps hold only (key, slot) pairs, and each
+// record's payload sits in a side array at its slot for as long as it is in
+// the heap. Sifts and scans touch only the dense key array, and a payload is
+// read only when a key matches. Keys are compared with < and >.
+template <typename Key, typename Payload>
+class KeyedMedianHeap {
+public:
+    // what the heaps hold in place of the record
+    struct Entry {
+        Key key;    // key the record is ordered by
+        int slot;   // index of record's payload in side array
+    };
+
+    // constructor for KeyedMedianHeap class
+    // must create a KeyedMedianHeap object capable of holding cap records
+    KeyedMedianHeap( int cap=100 ) ;
+
+    // copy constructor
+    KeyedMedianHeap(const KeyedMedianHeap<Key, Payload>& otherH) ;
+
+    // destructor
+    ~KeyedMedianHeap() ;
+
+    // overloaded assignment operator
+    const KeyedMedianHeap<Key, Payload>& operator=(const KeyedMedianHeap<Key, Payload>& rhs) ;
+
+    // returns the total number of records in the KeyedMedianHeap
+    int size() ;
+
+    // returns the maximum number of records that can be stored in the KeyedMedianHeap
+    int capacity() ;
+
+    // adds a record with the given key and payload
+    void insert(const Key& key, const Payload& payload) ;
+
+    // returns a copy of the median key
+    Key getMedian() ;
+
+    // returns a copy of the payload of the record with the median key
+    Payload getMedianPayload() ;
+
+    // returns a copy of the minimum key
+    Key getMin() ;
+
+    // returns a copy of the maximum key
+    Key getMax() ;
+
+    // deletes a record with key whose payload is equalTo givenPayload, copies the
+    // stored payload into givenPayload, returns true if found and false if unfound
+    bool deleteItem(const Key& key, Payload& givenPayload, bool (*equalTo) (const Payload&, const Payload&) ) ;
+
+    // prints out the keys and slots in each heap
+    void dump() ;
+
+    // returns the number of records in the max heap
+    int maxHeapSize() ;
+
+    // returns the number of records in the min heap
+    int minHeapSize() ;
+
+private:
+    // functions order entries by key alone
+    static bool entryLess(const Entry& a, const Entry& b) { return a.key < b.key; }
+    static bool entryGreater(const Entry& a, const Entry& b) { return a.key > b.key; }
+
+    bool removeFrom(Heap<Entry> *heap, const Key& key, Payload& givenPayload,
+                    bool (*equalTo) (const Payload&, const Payload&));   // deletes a match from heap
+    void findMin(); // finds new min
+    void findMax(); // finds new max
+    void balance(); // moves a root across if heaps differ by more than one
+    void copyFrom(const KeyedMedianHeap<Key, Payload>& other);  // deep copies other into host
+
+    Heap<Entry> *minHeap;   // min heap of upper half keys
+    Heap<Entry> *maxHeap;   // max heap of lower half keys
+
+    Payload *m_payloads;    // payload of each slot, never moved while in use
+    int *m_free;    // stack of unused slots
+    int m_freeTop;  // number of unused slots
+
+    Key m_min;  // min key in KeyedMedianHeap
+    Key m_max;  // max key in KeyedMedianHeap
+    int m_capacity; // capacity of heap
+};
+
+// constructor for KeyedMedianHeap class
+// heaps are sized the same as in MedianHeap, every slot starts free
+template <typename Key, typename Payload>
+KeyedMedianHeap<Key, Payload>::KeyedMedianHeap( int cap ) {
+    m_capacity = cap;
+    maxHeap = new Heap<Entry>((cap/2) + 2, entryGreater);
+    minHeap = new Heap<Entry>((cap/2) + 2, entryLess);
+
+    m_payloads = new Payload[cap];
+    m_free = new int[cap];
+    m_freeTop = 0;
+    for (int i = cap - 1; i >= 0; i--){
+        m_free[m_freeTop++] = i;
+    }
+}
+
+// KeyedMedianHeap class copy constructor
+// creates a deep copy of the passed in KeyedMedianHeap object
+template <typename Key, typename Payload>
+KeyedMedianHeap<Key, Payload>::KeyedMedianHeap(const KeyedMedianHeap<Key, Payload>& otherH) {
+    copyFrom(otherH);
+}
+
+// KeyedMedianHeap class destructor
+// deallocates any dynamically allocated memory
+template <typename Key, typename Payload>
+KeyedMedianHeap<Key, Payload>::~KeyedMedianHeap() {
+    delete maxHeap;
+    delete minHeap;
+    delete[] m_payloads;
+    delete[] m_free;
+    maxHeap = NULL;
+    minHeap = NULL;
+    m_capacity = 0;
+}
+
+// KeyedMedianHeap class overloaded assignment operator
+// deallocates memory of the host object and copies rhs into host
+template <typename Key, typename Payload>
+const KeyedMedianHeap<Key, Payload>& KeyedMedianHeap<Key, Payload>::operator=(const KeyedMedianHeap<Key, Payload>& rhs) {
+    // checks first for self-assignment, if true returns object
+    if(this == &rhs){
+        return *this;
+    }
+    delete maxHeap;
+    delete minHeap;
+    delete[] m_payloads;
+    delete[] m_free;
+    copyFrom(rhs);
+    return *this;
+}
+
+// copies heaps with the Heap copy constructor and the payloads in use
+template <typename Key, typename Payload>
+void KeyedMedianHeap<Key, Payload>::copyFrom(const KeyedMedianHeap<Key, Payload>& other) {
+    m_capacity = other.m_capacity;
+    m_min = other.m_min;
+    m_max = other.m_max;
+    m_freeTop = other.m_freeTop;
+
+    maxHeap = new Heap<Entry>(*(other.maxHeap));
+    minHeap = new Heap<Entry>(*(other.minHeap));
+
+    m_payloads = new Payload[m_capacity];
+    m_free = new int[m_capacity];
+    for (int i=0; i < m_freeTop; i++){
+        m_free[i] = other.m_free[i];
+    }
+    for (int i=1; i <= maxHeap->m_heapSize; i++){
+        int slot = maxHeap->m_heap[i].slot;
+        m_payloads[slot] = other.m_payloads[slot];
+    }
+    for (int i=1; i <= minHeap->m_heapSize; i++){
+        int slot = minHeap->m_heap[i].slot;
+        m_payloads[slot] = other.m_payloads[slot];
+    }
+}
+
+// returns the total number of records in the KeyedMedianHeap
+template <typename Key, typename Payload>
+int KeyedMedianHeap<Key, Payload>::size() {
+    return (minHeap->m_heapSize + maxHeap->m_heapSize);
+}
+
+// returns the maximum number of records that can be stored in the KeyedMedianHeap
+template <typename Key, typename Payload>
+int KeyedMedianHeap<Key, Payload>::capacity() {
+    return m_capacity;
+}
+
+// stores payload in a free slot, then adds (key, slot) the same way
+// MedianHeap::insert adds an item
+template <typename Key, typename Payload>
+void KeyedMedianHeap<Key, Payload>::insert(const Key& key, const Payload& payload) {
+    // if KeyedMedianHeap is full throw out of range error
+    if(size() == capacity()){
+        throw out_of_range("The KeyedMedianHeap is full. Cannot insert item.");
+    }
+    m_freeTop--;
+    Entry e;
+    e.key = key;
+    e.slot = m_free[m_freeTop];
+    m_payloads[e.slot] = payload;
+
+    // if KeyedMedianHeap is empty
+    if(size() == 0){
+        minHeap->insert(e);
+        m_min = key;
+        m_max = key;
+        return;
+    }
+    // if the key is less than median it belongs in the maxHeap
+    if(key < getMedian()){
+        if(maxHeap->m_heapSize > minHeap->m_heapSize){
+            minHeap->insert(maxHeap->pushPop(e));
+        }
+        else {
+            maxHeap->insert(e);
+        }
+        if(key < m_min) {m_min = key;}
+    }
+    // if key is greater than median it belongs in the minHeap
+    else {
+        if(minHeap->m_heapSize > maxHeap->m_heapSize){
+            maxHeap->insert(minHeap->pushPop(e));
+        }
+        else {
+            minHeap->insert(e);
+        }
+        if(key > m_max) {m_max = key;}
+    }
+}
+
+// returns a copy of the median key
+template <typename Key, typename Payload>
+Key KeyedMedianHeap<Key, Payload>::getMedian() {
+    if(size() == 0){
+        throw out_of_range("The KeyedMedianHeap is empty.");
+    }
+    if (minHeap->m_heapSize > maxHeap->m_heapSize){
+        return minHeap->m_heap[1].key;
+    }
+    return maxHeap->m_heap[1].key;
+}
+
+// returns a copy of the payload stored with the median key
+template <typename Key, typename Payload>
+Payload KeyedMedianHeap<Key, Payload>::getMedianPayload() {
+    if(size() == 0){
+        throw out_of_range("The KeyedMedianHeap is empty.");
+    }
+    if (minHeap->m_heapSize > maxHeap->m_heapSize){
+        return m_payloads[minHeap->m_heap[1].slot];
+    }
+    return m_payloads[maxHeap->m_heap[1].slot];
+}
+
+// returns a copy of the min key
+template <typename Key, typename Payload>
+Key KeyedMedianHeap<Key, Payload>::getMin() {
+    return m_min;
+}
+
+// returns a copy of the max key
+template <typename Key, typename Payload>
+Key KeyedMedianHeap<Key, Payload>::getMax() {
+    return m_max;
+}
+
+// looks for a record with key and a payload equalTo givenPayload, and if found
+// deletes it and returns true, if unfound KeyedMedianHeap is unchanged and returns false
+template <typename Key, typename Payload>
+bool KeyedMedianHeap<Key, Payload>::deleteItem(const Key& key, Payload& givenPayload,
+                                               bool (*equalTo) (const Payload&, const Payload&) ) {
+    // if the KeyedMedianHeap is empty throw out of range error
+    if(size() == 0) {
+        throw out_of_range("The heap is empty, cannot remove item.");
+    }
+    // key copied first, it may refer to a key stored in the heap
+    Key k = key;
+    if (!removeFrom(maxHeap, k, givenPayload, equalTo) && !removeFrom(minHeap, k, givenPayload, equalTo)){
+        return false;
+    }
+    balance();
+
+    // if deleted key was min or max find new one
+    if (size() > 0 && !(k < m_min) && !(k > m_min)){
+        findMin();
+    }
+    if (size() > 0 && !(k < m_max) && !(k > m_max)){
+        findMax();
+    }
+    return true;
+}
+
+// scans keys of heap and only checks a payload once its key matches
+template <typename Key, typename Payload>
+bool KeyedMedianHeap<Key, Payload>::removeFrom(Heap<Entry> *heap, const Key& key, Payload& givenPayload,
+                                               bool (*equalTo) (const Payload&, const Payload&)) {
+    for (int i=1; i <= heap->m_heapSize; i++){
+        const Entry& e = heap->m_heap[i];
+        if (!(e.key < key) && !(e.key > key) && equalTo(m_payloads[e.slot], givenPayload)){
+            givenPayload = m_payloads[e.slot];
+            m_free[m_freeTop] = e.slot;
+            m_freeTop++;
+            heap->deleteH(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// called when min is deleted, smallest key is a leaf of the max heap
+template <typename Key, typename Payload>
+void KeyedMedianHeap<Key, Payload>::findMin() {
+    if(maxHeap->m_heapSize == 0){
+        m_min = minHeap->m_heap[1].key;
+        return;
+    }
+    Key temp = maxHeap->m_heap[1].key;
+    for(int i = maxHeap->m_heapSize/2 + 1; i <= maxHeap->m_heapSize; i++){
+        if(maxHeap->m_heap[i].key < temp){
+            temp = maxHeap->m_heap[i].key;
+        }
+    }
+    m_min = temp;
+}
+
+// called when max is deleted, largest key is a leaf of the min heap
+template <typename Key, typename Payload>
+void KeyedMedianHeap<Key, Payload>::findMax() {
+    if(minHeap->m_heapSize == 0){
+        m_max = maxHeap->m_heap[1].key;
+        return;
+    }
+    Key temp = minHeap->m_heap[1].key;
+    for(int i = minHeap->m_heapSize/2 + 1; i <= minHeap->m_heapSize; i++){
+        if(minHeap->m_heap[i].key > temp){
+            temp = minHeap->m_heap[i].key;
+        }
+    }
+    m_max = temp;
+}
+
+// moves the root of the bigger heap into the other if they differ by more than one
+template <typename Key, typename Payload>
+void KeyedMedianHeap<Key, Payload>::balance() {
+    if(maxHeap->m_heapSize > minHeap->m_heapSize + 1) {
+        minHeap->insert(maxHeap->m_heap[1]);
+        maxHeap->deleteH(1);
+    }
+    else if (minHeap->m_heapSize > maxHeap->m_heapSize + 1) {
+        maxHeap->insert(minHeap->m_heap[1]);
+        minHeap->deleteH(1);
+    }
+}
+
+// prints out keys and payload slots of max and min heap
+template <typename Key, typename Payload>
+void KeyedMedianHeap<Key, Payload>::dump() {
+    cout << "... KeyedMedianHeap()::dump() ..." << endl;
+    cout << endl;
+    // prints max heap data
+    cout << "------------Max Heap------------" << endl;
+    cout << "size = " << maxHeap->m_heapSize << ", ";
+    cout << "capacity = " << maxHeap->m_heapCap - 1 << endl;
+    for (int i=1; i <= maxHeap->m_heapSize; i++){
+        cout << "Heap[" << i << "] = (" << maxHeap->m_heap[i].key << ", slot " << maxHeap->m_heap[i].slot << ")" << endl;
+    }
+    cout << endl;
+
+    // prints min heap data
+    cout << "------------Min Heap------------" << endl;
+    cout << "size = " << minHeap->m_heapSize << ", ";
+    cout << "capacity = " << minHeap->m_heapCap - 1 << endl;
+    for (int i=1; i <= minHeap->m_heapSize; i++){
+        cout << "Heap[" << i << "] = (" << minHeap->m_heap[i].key << ", slot " << minHeap->m_heap[i].slot << ")" << endl;
+    }
+
+    cout << "--------------------------------" << endl;
+    if (size() > 0){
+        cout << "min    = " << m_min << endl;
+        cout << "median = " << getMedian() << endl;
+        cout << "max    = " << m_max << endl;
+    }
+}
+
+// returns the number of records in the max heap
+template <typename Key, typename Payload>
+int KeyedMedianHeap<Key, Payload>::maxHeapSize() {
+    return maxHeap->m_heapSize;
+}
+
+// returns the number of records in the min heap
+template <typename Key, typename Payload>
+int KeyedMedianHeap<Key, Payload>::minHeapSize() {
+    return minHeap->m_heapSize;
+}
+
+#endif
@@ -0,0 +1,566 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    LaneMedianHeap.h
+*/
+
+#ifndef _LANEMEDIANHEAP_H_
+#define _LANEMEDIANHEAP_H_
+
+#include <iostream>
+#include <stdexcept>
+using namespace std;
+
+// LaneMedianHeap keeps the median of each of LANES dimensions of a stream of
+// fixed width samples, in place of one MedianHeap per dimension. Every lane
+// has a max heap of its lower half and a min heap of its upper half, and all
+// lanes share one array per half in structure of arrays form: row pos holds
+// heap position pos of every lane side by side.
+//
+// Lanes are balanced the same way as MedianHeap. With an even count both
+// halves of every lane hold size()/2 items and the sample's item goes to the
+// half it belongs in. With an odd count one half of each lane has the extra
+// item, and which one is kept per lane. The other half always grows, taking
+// the item or else the root it pushes out of the fuller half. Either way a
+// new item goes in as row size()/2+1 of one half in every lane, and only about
+// a quarter of the lanes have to trickle down a new root, same as MedianHeap.
+//
+// Roots that are replaced trickle down a different path in each lane, so
+// those lanes walk down one level at a time together with no branches on
+// the items, and their loads overlap instead of waiting on each other. Items
+// are compared with < and >, so there are no comparison function calls.
+template <typename T, int LANES>
+class LaneMedianHeap {
+public:
+    // constructor for LaneMedianHeap class
+    // must create a LaneMedianHeap object capable of holding cap samples
+    LaneMedianHeap( int cap=100 ) ;
+
+    // copy constructor
+    LaneMedianHeap(const LaneMedianHeap<T, LANES>& otherH) ;
+
+    // destructor
+    ~LaneMedianHeap() ;
+
+    // overloaded assignment operator
+    const LaneMedianHeap<T, LANES>& operator=(const LaneMedianHeap<T, LANES>& rhs) ;
+
+    // returns the number of samples in the LaneMedianHeap
+    int size() ;
+
+    // returns the maximum number of samples that can be stored
+    int capacity() ;
+
+    // adds a sample, sample[lane] goes to each lane
+    void insert(const T* sample) ;
+
+    // out[lane] gets the median of each lane
+    void getMedians(T* out) ;
+
+    // returns a copy of the median of one lane
+    T getMedian(int lane) ;
+
+    // out[lane] gets the minimum of each lane
+    void getMins(T* out) ;
+
+    // out[lane] gets the maximum of each lane
+    void getMaxes(T* out) ;
+
+    // deletes one copy of sample[lane] from each lane and returns true
+    // if any lane doesn't hold its item, nothing changes and returns false
+    bool deleteSample(const T* sample) ;
+
+    // prints out the rows of both halves
+    void dump() ;
+
+private:
+    T* row(T *heap, int pos) { return heap + (long long)pos * LANES; }  // position pos of every lane
+    bool before(const T& a, const T& b, bool isLower) { return isLower ? a > b : a < b; }   // a belongs above b
+    int lowerSize(int lane) ;   // items in one lane's lower half
+    int upperSize(int lane) ;   // items in one lane's upper half
+
+    void pushAll(T *heap, int pos, bool isLower, const T* items, const bool* mask) ;    // adds items as position pos
+    void replaceTopAll(T *heap, int size, bool isLower, const T* items, const bool* mask) ;  // replaces roots
+    void siftUp(T *heap, bool isLower, int pos, int lane) ;     // moves one lane's item up
+    void siftDown(T *heap, int size, bool isLower, int pos, int lane) ; // moves one lane's item down
+    void removeAt(T *heap, int size, bool isLower, int pos, int lane) ;  // fills pos with the last item
+    int find(T *heap, int size, int lane, const T& item) ;  // position of item in lane, 0 if missing
+    void findMinMax(int lane) ;     // scans lane for its new min and max
+    void copyFrom(const LaneMedianHeap<T, LANES>& other) ;  // deep copies other into host
+
+    T *m_lower;     // max heaps of lower halves, 1 based rows
+    T *m_upper;     // min heaps of upper halves, 1 based rows
+    int m_size;     // samples in every lane
+    bool m_extraLower[LANES];   // with an odd size, true if the lower half has the extra item
+    int m_heapCap;  // rows in each half
+    T m_min[LANES];     // min of each lane
+    T m_max[LANES];     // max of each lane
+    int m_capacity;
+};
+
+// constructor for LaneMedianHeap class
+// each half needs (cap+1)/2 rows after row 0, which is unused
+template <typename T, int LANES>
+LaneMedianHeap<T, LANES>::LaneMedianHeap( int cap ) {
+    if (cap < 1){
+        throw out_of_range("Capacity must be at least one.");
+    }
+    m_capacity = cap;
+    m_heapCap = (cap + 1) / 2;
+    m_lower = new T[(long long)(m_heapCap + 1) * LANES];
+    m_upper = new T[(long long)(m_heapCap + 1) * LANES];
+    m_size = 0;
+}
+
+// LaneMedianHeap class copy constructor
+template <typename T, int LANES>
+LaneMedianHeap<T, LANES>::LaneMedianHeap(const LaneMedianHeap<T, LANES>& otherH) {
+    copyFrom(otherH);
+}
+
+// LaneMedianHeap class destructor
+// deallocates any dynamically allocated memory
+template <typename T, int LANES>
+LaneMedianHeap<T, LANES>::~LaneMedianHeap() {
+    delete[] m_lower;
+    delete[] m_upper;
+    m_lower = NULL;
+    m_upper = NULL;
+    m_capacity = 0;
+}
+
+// LaneMedianHeap class overloaded assignment operator
+// deallocates memory of the host object and copies rhs into host
+template <typename T, int LANES>
+const LaneMedianHeap<T, LANES>& LaneMedianHeap<T, LANES>::operator=(const LaneMedianHeap<T, LANES>& rhs) {
+    // checks first for self-assignment, if true returns object
+    if(this == &rhs){
+        return *this;
+    }
+    delete[] m_lower;
+    delete[] m_upper;
+    copyFrom(rhs);
+    return *this;
+}
+
+// allocates halves the same size as other's and copies every row a lane
+// could be using
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::copyFrom(const LaneMedianHeap<T, LANES>& other) {
+    m_capacity = other.m_capacity;
+    m_heapCap = other.m_heapCap;
+    m_size = other.m_size;
+    m_lower = new T[(long long)(m_heapCap + 1) * LANES];
+    m_upper = new T[(long long)(m_heapCap + 1) * LANES];
+    for (long long i = LANES; i < (long long)((m_size + 1) / 2 + 1) * LANES; i++){
+        m_lower[i] = other.m_lower[i];
+        m_upper[i] = other.m_upper[i];
+    }
+    for (int lane=0; lane < LANES; lane++){
+        m_extraLower[lane] = other.m_extraLower[lane];
+        m_min[lane] = other.m_min[lane];
+        m_max[lane] = other.m_max[lane];
+    }
+}
+
+// returns the number of samples
+template <typename T, int LANES>
+int LaneMedianHeap<T, LANES>::size() {
+    return m_size;
+}
+
+// returns the maximum number of samples that can be stored
+template <typename T, int LANES>
+int LaneMedianHeap<T, LANES>::capacity() {
+    return m_capacity;
+}
+
+// returns the items in one lane's lower half
+template <typename T, int LANES>
+int LaneMedianHeap<T, LANES>::lowerSize(int lane) {
+    return m_size / 2 + (int)(m_size % 2 == 1 && m_extraLower[lane]);
+}
+
+// returns the items in one lane's upper half
+template <typename T, int LANES>
+int LaneMedianHeap<T, LANES>::upperSize(int lane) {
+    return m_size / 2 + (int)(m_size % 2 == 1 && !m_extraLower[lane]);
+}
+
+// puts items[lane] in as position pos of every lane in mask and bubbles each
+// one up. The lanes climb the same path, so the rows they touch are the same
+// few cache lines. Most items stop after a level or two, so each lane is left
+// to stop on its own rather than keeping every lane climbing together
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::pushAll(T *heap, int pos, bool isLower, const T* items, const bool* mask) {
+    T *added = row(heap, pos);
+    for (int lane=0; lane < LANES; lane++){
+        if (mask[lane]){
+            added[lane] = items[lane];
+            siftUp(heap, isLower, pos, lane);
+        }
+    }
+}
+
+// puts items[lane] at the root of every lane in mask, where every one of
+// those lanes holds size items. The lanes walk their holes from the root to
+// a leaf together, always moving up the child that belongs higher, which is
+// the same number of steps in every lane and needs no branches. Then each
+// item bubbles up from its lane's leaf, which is usually only a step or two
+// since an item that left the root mostly belongs near the bottom
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::replaceTopAll(T *heap, int size, bool isLower, const T* items, const bool* mask) {
+    int lanes[LANES];   // lanes in mask
+    int pos[LANES];     // hole of each of those lanes
+    int moving = 0;
+    for (int lane=0; lane < LANES; lane++){
+        lanes[moving] = lane;
+        pos[moving] = 1;
+        moving += (int)mask[lane];
+    }
+    // levels whose children are all there
+    int first = 1;  // first position on the current level
+    while (4 * first - 1 <= size){
+        for (int i=0; i < moving; i++){
+            int lane = lanes[i];
+            int p = pos[i];
+            int c = 2 * p;
+            T left = heap[(long long)c * LANES + lane];
+            T right = heap[(long long)(c + 1) * LANES + lane];
+            c += (int)before(right, left, isLower);
+            heap[(long long)p * LANES + lane] = heap[(long long)c * LANES + lane];
+            pos[i] = c;
+        }
+        first *= 2;
+    }
+    for (int i=0; i < moving; i++){
+        int lane = lanes[i];
+        int p = pos[i];
+        // last level may be missing children
+        int c = 2 * p;
+        if (c <= size){
+            if (c + 1 <= size){
+                c += (int)before(heap[(long long)(c + 1) * LANES + lane], heap[(long long)c * LANES + lane], isLower);
+            }
+            heap[(long long)p * LANES + lane] = heap[(long long)c * LANES + lane];
+            p = c;
+        }
+        // bubble item up from the hole
+        T item = items[lane];
+        while (p > 1){
+            T parent = heap[(long long)(p / 2) * LANES + lane];
+            if (!before(item, parent, isLower)){
+                break;
+            }
+            heap[(long long)p * LANES + lane] = parent;
+            p = p / 2;
+        }
+        heap[(long long)p * LANES + lane] = item;
+    }
+}
+
+// adds sample[lane] to each lane. The half that grows in a lane gets the
+// item, or the root of the fuller half if the item has to go there instead
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::insert(const T* sample) {
+    // if LaneMedianHeap is full throw out of range error
+    if(size() == capacity()){
+        throw out_of_range("The LaneMedianHeap is full. Cannot insert item.");
+    }
+    T grow[LANES];      // item each lane adds to its growing half
+    T top[LANES];       // new root of each lane's fuller half
+    bool toLower[LANES];    // lanes whose lower half grows
+    bool toUpper[LANES];    // lanes whose upper half grows
+    bool lowerTop[LANES];   // lanes whose lower root is replaced
+    bool upperTop[LANES];   // lanes whose upper root is replaced
+    if (size() == 0){
+        for (int lane=0; lane < LANES; lane++){
+            m_min[lane] = sample[lane];
+            m_max[lane] = sample[lane];
+        }
+    }
+    for (int lane=0; lane < LANES; lane++){
+        T x = sample[lane];
+        m_min[lane] = x < m_min[lane] ? x : m_min[lane];
+        m_max[lane] = x > m_max[lane] ? x : m_max[lane];
+    }
+
+    int pos = m_size / 2 + 1;   // row the growing halves add
+    T *lowerRoot = row(m_lower, 1);
+    T *upperRoot = row(m_upper, 1);
+    if (m_size % 2 == 0){
+        // each lane's item goes to the half it belongs in, that half gets the extra
+        for (int lane=0; lane < LANES; lane++){
+            toLower[lane] = m_size == 0 || sample[lane] < lowerRoot[lane];
+            toUpper[lane] = !toLower[lane];
+            m_extraLower[lane] = toLower[lane];
+        }
+        pushAll(m_lower, pos, true, sample, toLower);
+        pushAll(m_upper, pos, false, sample, toUpper);
+    }
+    else {
+        // the half without the extra grows, and if the item belongs in the
+        // fuller half it replaces that root, which moves across instead
+        for (int lane=0; lane < LANES; lane++){
+            T x = sample[lane];
+            bool extra = m_extraLower[lane];
+            T root = extra ? lowerRoot[lane] : upperRoot[lane];
+            bool swap = extra ? x < root : x > root;
+            grow[lane] = swap ? root : x;
+            top[lane] = x;
+            lowerTop[lane] = extra && swap;
+            upperTop[lane] = !extra && swap;
+            toLower[lane] = !extra;
+            toUpper[lane] = extra;
+        }
+        replaceTopAll(m_lower, pos, true, top, lowerTop);
+        replaceTopAll(m_upper, pos, false, top, upperTop);
+        pushAll(m_lower, pos, true, grow, toLower);
+        pushAll(m_upper, pos, false, grow, toUpper);
+    }
+    m_size++;
+}
+
+// copies the median of every lane, the lower root unless the upper half
+// has the extra item
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::getMedians(T* out) {
+    if(size() == 0){
+        throw out_of_range("The LaneMedianHeap is empty.");
+    }
+    for (int lane=0; lane < LANES; lane++){
+        out[lane] = getMedian(lane);
+    }
+}
+
+// returns the median of one lane
+template <typename T, int LANES>
+T LaneMedianHeap<T, LANES>::getMedian(int lane) {
+    if(size() == 0){
+        throw out_of_range("The LaneMedianHeap is empty.");
+    }
+    if (lane < 0 || lane >= LANES){
+        throw out_of_range("Lane is invalid or out of range.");
+    }
+    if (m_size % 2 == 1 && !m_extraLower[lane]){
+        return row(m_upper, 1)[lane];
+    }
+    return row(m_lower, 1)[lane];
+}
+
+// copies the min of every lane
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::getMins(T* out) {
+    if(size() == 0){
+        throw out_of_range("The LaneMedianHeap is empty.");
+    }
+    for (int lane=0; lane < LANES; lane++){
+        out[lane] = m_min[lane];
+    }
+}
+
+// copies the max of every lane
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::getMaxes(T* out) {
+    if(size() == 0){
+        throw out_of_range("The LaneMedianHeap is empty.");
+    }
+    for (int lane=0; lane < LANES; lane++){
+        out[lane] = m_max[lane];
+    }
+}
+
+// moves one lane's item at pos up until its parent belongs above it
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::siftUp(T *heap, bool isLower, int pos, int lane) {
+    T item = heap[(long long)pos * LANES + lane];
+    while (pos > 1){
+        T parent = heap[(long long)(pos / 2) * LANES + lane];
+        if (!before(item, parent, isLower)){
+            break;
+        }
+        heap[(long long)pos * LANES + lane] = parent;
+        pos = pos / 2;
+    }
+    heap[(long long)pos * LANES + lane] = item;
+}
+
+// moves one lane's item at pos down until both children belong below it
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::siftDown(T *heap, int size, bool isLower, int pos, int lane) {
+    T item = heap[(long long)pos * LANES + lane];
+    while (2 * pos <= size){
+        int c = 2 * pos;
+        T child = heap[(long long)c * LANES + lane];
+        if (c + 1 <= size){
+            T right = heap[(long long)(c + 1) * LANES + lane];
+            if (before(right, child, isLower)){
+                c++;
+                child = right;
+            }
+        }
+        if (!before(child, item, isLower)){
+            break;
+        }
+        heap[(long long)pos * LANES + lane] = child;
+        pos = c;
+    }
+    heap[(long long)pos * LANES + lane] = item;
+}
+
+// takes one lane's item at pos out of a half holding size items, the last
+// item fills the hole and moves whichever way it must
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::removeAt(T *heap, int size, bool isLower, int pos, int lane) {
+    heap[(long long)pos * LANES + lane] = heap[(long long)size * LANES + lane];
+    if (pos < size){
+        siftUp(heap, isLower, pos, lane);
+        siftDown(heap, size - 1, isLower, pos, lane);
+    }
+}
+
+// returns the first position in heap where lane holds item, 0 if none
+template <typename T, int LANES>
+int LaneMedianHeap<T, LANES>::find(T *heap, int size, int lane, const T& item) {
+    for (int pos=1; pos <= size; pos++){
+        if (heap[(long long)pos * LANES + lane] == item){
+            return pos;
+        }
+    }
+    return 0;
+}
+
+// scans one lane, the min is a lower leaf and the max an upper leaf
+// unless that half is empty, then it's the other half's root
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::findMinMax(int lane) {
+    int lower = lowerSize(lane);
+    int upper = upperSize(lane);
+    if (lower == 0){
+        m_min[lane] = m_upper[LANES + lane];
+    }
+    else {
+        m_min[lane] = m_lower[LANES + lane];
+        for (int pos = lower / 2 + 1; pos <= lower; pos++){
+            T item = m_lower[(long long)pos * LANES + lane];
+            m_min[lane] = item < m_min[lane] ? item : m_min[lane];
+        }
+    }
+    if (upper == 0){
+        m_max[lane] = m_lower[LANES + lane];
+    }
+    else {
+        m_max[lane] = m_upper[LANES + lane];
+        for (int pos = upper / 2 + 1; pos <= upper; pos++){
+            T item = m_upper[(long long)pos * LANES + lane];
+            m_max[lane] = item > m_max[lane] ? item : m_max[lane];
+        }
+    }
+}
+
+// each lane takes its item out of the half it is in. With an even size the
+// other half now has the extra item. With an odd size the halves are even
+// again, unless the item came out of the smaller half, then the root of the
+// fuller half moves across to fill it
+template <typename T, int LANES>
+bool LaneMedianHeap<T, LANES>::deleteSample(const T* sample) {
+    // if the LaneMedianHeap is empty throw out of range error
+    if(size() == 0){
+        throw out_of_range("The heap is empty, cannot remove item.");
+    }
+    int lowerPos[LANES];
+    int upperPos[LANES];
+    for (int lane=0; lane < LANES; lane++){
+        lowerPos[lane] = find(m_lower, lowerSize(lane), lane, sample[lane]);
+        upperPos[lane] = lowerPos[lane] ? 0 : find(m_upper, upperSize(lane), lane, sample[lane]);
+        if (lowerPos[lane] == 0 && upperPos[lane] == 0){
+            return false;
+        }
+    }
+
+    bool odd = m_size % 2 == 1;
+    for (int lane=0; lane < LANES; lane++){
+        int lower = lowerSize(lane);
+        int upper = upperSize(lane);
+        bool fromLower = lowerPos[lane] != 0;
+        if (fromLower){
+            removeAt(m_lower, lower, true, lowerPos[lane], lane);
+            lower--;
+        }
+        else {
+            removeAt(m_upper, upper, false, upperPos[lane], lane);
+            upper--;
+        }
+        if (!odd){
+            m_extraLower[lane] = !fromLower;
+        }
+        else if (lower + 1 < upper){
+            // upper root moves down to the lower half
+            T root = m_upper[LANES + lane];
+            removeAt(m_upper, upper, false, 1, lane);
+            m_lower[(long long)(lower + 1) * LANES + lane] = root;
+            siftUp(m_lower, true, lower + 1, lane);
+        }
+        else if (upper + 1 < lower){
+            // lower root moves up to the upper half
+            T root = m_lower[LANES + lane];
+            removeAt(m_lower, lower, true, 1, lane);
+            m_upper[(long long)(upper + 1) * LANES + lane] = root;
+            siftUp(m_upper, false, upper + 1, lane);
+        }
+    }
+    m_size--;
+    if (size() > 0){
+        for (int lane=0; lane < LANES; lane++){
+            if (!(sample[lane] > m_min[lane]) || !(sample[lane] < m_max[lane])){
+                findMinMax(lane);
+            }
+        }
+    }
+    return true;
+}
+
+// prints out each row of both halves, one column per lane, with a - where
+// a lane's half is one item shorter
+template <typename T, int LANES>
+void LaneMedianHeap<T, LANES>::dump() {
+    cout << "... LaneMedianHeap()::dump() ..." << endl;
+    cout << endl;
+    cout << "size = " << size() << ", ";
+    cout << "capacity = " << m_capacity << ", ";
+    cout << "lanes = " << LANES << endl;
+    int rows = (m_size + 1) / 2;
+    cout << "------------Max Heap------------" << endl;
+    for (int pos=1; pos <= rows; pos++){
+        cout << "Heap[" << pos << "] = (";
+        for (int lane=0; lane < LANES; lane++){
+            cout << (lane ? ", " : "");
+            if (pos <= lowerSize(lane)){
+                cout << m_lower[(long long)pos * LANES + lane];
+            }
+            else {
+                cout << "-";
+            }
+        }
+        cout << ")" << endl;
+    }
+    cout << "------------Min Heap------------" << endl;
+    for (int pos=1; pos <= rows; pos++){
+        cout << "Heap[" << pos << "] = (";
+        for (int lane=0; lane < LANES; lane++){
+            cout << (lane ? ", " : "");
+            if (pos <= upperSize(lane)){
+                cout << m_upper[(long long)pos * LANES + lane];
+            }
+            else {
+                cout << "-";
+            }
+        }
+        cout << ")" << endl;
+    }
+    cout << "--------------------------------" << endl;
+}
+
+#endif
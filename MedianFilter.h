@@ -0,0 +1,267 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    MedianFilter.h
+*/
+
+#ifndef _MEDIANFILTER_H_
+#define _MEDIANFILTER_H_
+
+#include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// running median filter over an array
+// output[i] is the median of input[i] ... input[i+window-1], for i from 0 to
+// n-window, so output must have room for n-window+1 items. For an even window
+// the lower middle is used, same as MedianHeap. Items are compared with <.
+template <typename T>
+void medianFilter(const T* input, T* output, int n, int window, int threads=0);
+
+const int FILTER_NETWORK_MAX = 9;       // largest window sorted with a network
+const int FILTER_BLOCK = 64;            // outputs computed together by a network
+const int FILTER_MIN_CHUNK = 1 << 16;   // fewest outputs worth giving a thread
+
+// SlidingMedian keeps one window in a max heap (lower half) and a min heap
+// (upper half) that hold slot numbers instead of items. Each slot remembers
+// which heap it is in and where, so the item leaving the window is replaced
+// in place by the one entering, and both heaps keep the same size.
+template <typename T>
+class SlidingMedian {
+public:
+    // builds heaps from the first window items of input
+    SlidingMedian(const T* input, int window);
+    ~SlidingMedian();
+
+    // replaces item in slot with item and returns the new median
+    T replace(int slot, const T& item);
+
+    // returns the current median, root of the lower heap
+    T getMedian() { return m_items[m_lower[1]]; }
+
+private:
+    SlidingMedian(const SlidingMedian<T>& other);   // not copyable
+    const SlidingMedian<T>& operator=(const SlidingMedian<T>& rhs);
+
+    // functions compare slots, lower heap keeps its largest item on top
+    bool lowerFirst(int a, int b) { return m_items[b] < m_items[a]; }
+    bool upperFirst(int a, int b) { return m_items[a] < m_items[b]; }
+
+    void place(int *heap, int pos, int slot);   // puts slot at pos and records it
+    void siftUp(int *heap, bool isLower, int pos);  // moves slot up heap
+    void siftDown(int *heap, int size, bool isLower, int pos);  // moves slot down heap
+
+    T *m_items;     // item in each slot, slot is index % window
+    int *m_lower;   // max heap of slots, 1 based
+    int *m_upper;   // min heap of slots, 1 based
+    int *m_pos;     // position of each slot in its heap
+    bool *m_inLower;    // true if slot is in lower heap
+    int m_lowerSize;    // (window+1)/2, lower heap holds the median
+    int m_upperSize;    // window/2
+};
+
+// sorts the first window slots and splits them into the two heaps
+// a descending array is already a max heap and an ascending one a min heap
+template <typename T>
+SlidingMedian<T>::SlidingMedian(const T* input, int window) {
+    m_items = new T[window];
+    m_lower = new int[(window+1)/2 + 1];
+    m_upper = new int[window/2 + 1];
+    m_pos = new int[window];
+    m_inLower = new bool[window];
+    m_lowerSize = (window+1)/2;
+    m_upperSize = window/2;
+
+    vector<int> order(window);
+    for (int i=0; i < window; i++){
+        m_items[i] = input[i];
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [this](int a, int b) { return m_items[a] < m_items[b]; });
+
+    for (int i=0; i < m_lowerSize; i++){
+        m_inLower[order[m_lowerSize - 1 - i]] = true;
+        place(m_lower, i + 1, order[m_lowerSize - 1 - i]);
+    }
+    for (int i=0; i < m_upperSize; i++){
+        m_inLower[order[m_lowerSize + i]] = false;
+        place(m_upper, i + 1, order[m_lowerSize + i]);
+    }
+}
+
+// deallocates heap and slot arrays
+template <typename T>
+SlidingMedian<T>::~SlidingMedian() {
+    delete[] m_items;
+    delete[] m_lower;
+    delete[] m_upper;
+    delete[] m_pos;
+    delete[] m_inLower;
+}
+
+// puts slot at pos in heap and records its position
+template <typename T>
+void SlidingMedian<T>::place(int *heap, int pos, int slot) {
+    heap[pos] = slot;
+    m_pos[slot] = pos;
+}
+
+// moves slot at pos up until its parent comes before it
+template <typename T>
+void SlidingMedian<T>::siftUp(int *heap, bool isLower, int pos) {
+    int slot = heap[pos];
+    while (pos > 1){
+        int p = pos / 2;
+        bool before = isLower ? lowerFirst(slot, heap[p]) : upperFirst(slot, heap[p]);
+        if (!before){
+            break;
+        }
+        place(heap, pos, heap[p]);
+        pos = p;
+    }
+    place(heap, pos, slot);
+}
+
+// moves slot at pos down until both children come after it
+template <typename T>
+void SlidingMedian<T>::siftDown(int *heap, int size, bool isLower, int pos) {
+    int slot = heap[pos];
+    while (2 * pos <= size){
+        int c = 2 * pos;
+        // pick the child that should be on top
+        if (c + 1 <= size && (isLower ? lowerFirst(heap[c+1], heap[c]) : upperFirst(heap[c+1], heap[c]))){
+            c++;
+        }
+        bool before = isLower ? lowerFirst(heap[c], slot) : upperFirst(heap[c], slot);
+        if (!before){
+            break;
+        }
+        place(heap, pos, heap[c]);
+        pos = c;
+    }
+    place(heap, pos, slot);
+}
+
+// overwrites slot with item, restores its heap, then swaps the two roots
+// if they are out of order, which is the only way the halves can cross
+template <typename T>
+T SlidingMedian<T>::replace(int slot, const T& item) {
+    m_items[slot] = item;
+    if (m_inLower[slot]){
+        siftUp(m_lower, true, m_pos[slot]);
+        siftDown(m_lower, m_lowerSize, true, m_pos[slot]);
+    }
+    else {
+        siftUp(m_upper, false, m_pos[slot]);
+        siftDown(m_upper, m_upperSize, false, m_pos[slot]);
+    }
+
+    if (m_upperSize > 0 && m_items[m_upper[1]] < m_items[m_lower[1]]){
+        int lo = m_lower[1];
+        int hi = m_upper[1];
+        m_inLower[lo] = false;
+        m_inLower[hi] = true;
+        place(m_lower, 1, hi);
+        place(m_upper, 1, lo);
+        siftDown(m_lower, m_lowerSize, true, 1);
+        siftDown(m_upper, m_upperSize, false, 1);
+    }
+    return getMedian();
+}
+
+// computes outputs first to last of a small window with a sorting network
+// a block of outputs is laid out as window rows so each compare and swap is a
+// loop of mins and maxes the compiler can turn into SIMD for number types
+template <typename T>
+void networkFilter(const T* input, T* output, int first, int last, int window) {
+    T rows[FILTER_NETWORK_MAX][FILTER_BLOCK];
+    int mid = (window - 1) / 2;
+
+    for (int start = first; start < last; start += FILTER_BLOCK){
+        // a short last block repeats its final window in the unused columns so
+        // every compare loop has the same fixed length
+        int count = min(FILTER_BLOCK, last - start);
+        for (int k=0; k < window; k++){
+            for (int j=0; j < FILTER_BLOCK; j++){
+                rows[k][j] = input[start + min(j, count - 1) + k];
+            }
+        }
+        // odd even transposition sort, window rounds sorts window rows
+        for (int round=0; round < window; round++){
+            for (int k = round % 2; k + 1 < window; k += 2){
+                T *a = rows[k];
+                T *b = rows[k+1];
+                for (int j=0; j < FILTER_BLOCK; j++){
+                    T x = a[j];
+                    T y = b[j];
+                    a[j] = min(x, y);
+                    b[j] = max(x, y);
+                }
+            }
+        }
+        for (int j=0; j < count; j++){
+            output[start + j] = rows[mid][j];
+        }
+    }
+}
+
+// computes outputs first to last of a large window with a SlidingMedian
+// the heaps are built from the window of the first output only
+template <typename T>
+void heapFilter(const T* input, T* output, int first, int last, int window) {
+    SlidingMedian<T> sm(input + first, window);
+    output[first] = sm.getMedian();
+    for (int i = first + 1; i < last; i++){
+        // item leaving is input[i-1], which is in slot (i-1-first) % window
+        output[i] = sm.replace((i - 1 - first) % window, input[i + window - 1]);
+    }
+}
+
+// computes outputs first to last with whichever method suits window
+template <typename T>
+void filterRange(const T* input, T* output, int first, int last, int window) {
+    if (window <= FILTER_NETWORK_MAX){
+        networkFilter(input, output, first, last, window);
+    }
+    else {
+        heapFilter(input, output, first, last, window);
+    }
+}
+
+// splits outputs into chunks and runs each on its own thread
+// neighboring chunks read window-1 of the same inputs, outputs never overlap
+template <typename T>
+void medianFilter(const T* input, T* output, int n, int window, int threads) {
+    if (window < 1 || window > n){
+        throw out_of_range("Window size is invalid or out of range.");
+    }
+    int outputs = n - window + 1;
+
+    if (threads <= 0){
+        threads = (int)thread::hardware_concurrency();
+    }
+    // don't start threads that would each get a tiny chunk
+    threads = min(threads, outputs / FILTER_MIN_CHUNK);
+    if (threads <= 1){
+        filterRange(input, output, 0, outputs, window);
+        return;
+    }
+
+    vector<thread> workers;
+    int chunk = (outputs + threads - 1) / threads;
+    for (int first = chunk; first < outputs; first += chunk){
+        int last = min(outputs, first + chunk);
+        workers.push_back(thread(filterRange<T>, input, output, first, last, window));
+    }
+    // this thread does the first chunk
+    filterRange(input, output, 0, min(outputs, chunk), window);
+    for (size_t i=0; i < workers.size(); i++){
+        workers[i].join();
+    }
+}
+
+#endif
@@ -11,8 +11,48 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
+#include <type_traits>
 using namespace std;
 
+// running sum and sum of squares of the items in a Heap, so the mean and
+// variance of each half of a MedianHeap are O(1) reads. Only number types
+// keep them; for any other type every call does nothing and takes no space.
+// The sums are of each item minus shift, the first item added to an empty
+// heap, so large items close together don't cancel away the variance.
+template <typename T, bool = is_arithmetic<T>::value>
+struct HeapSums {
+    void add(const T&) {}
+    void remove(const T&) {}
+    void clear() {}
+};
+
+template <typename T>
+struct HeapSums<T, true> {
+    double shift;   // subtracted from every item before it is summed
+    double sum;     // sum of items minus shift
+    double sumSq;   // sum of squares of items minus shift
+    int count;      // number of items summed
+
+    HeapSums() : shift(0), sum(0), sumSq(0), count(0) {}
+    void add(const T& item) {
+        if (count == 0){ clear(); shift = (double)item; }
+        double d = (double)item - shift;
+        sum += d; sumSq += d * d; count++;
+    }
+    void remove(const T& item) { double d = (double)item - shift; sum -= d; sumSq -= d * d; count--; }
+    void clear() { shift = 0; sum = 0; sumSq = 0; count = 0; }
+
+    double total() const { return shift * count + sum; }   // sum of items
+    double mean() const { return shift + sum / count; }     // mean of items
+    // population variance, only rounding can take it below 0
+    double variance() const {
+        double m = sum / count;
+        double v = sumSq / count - m * m;
+        return v > 0 ? v : 0;
+    }
+};
+
 template <typename T>
 class Heap {
 public: 
@@ -26,6 +66,13 @@ public:
     void deleteH(int pos);  // deletes item at specified position
     void trickleDown(int pos);  // moves item down in heap if not in correct position
     void swap(T &v1, T &v2);    // swaps passed in items
+    T replaceTop(const T& item);    // replaces root with item, returns old root
+    T pushPop(const T& item);   // inserts item then removes root, returns removed item
+    void buildHeap();   // puts whole array in heap order from the bottom up, recounts sums
+
+    // deletes every item match returns true for, returns number deleted
+    template <typename Match>
+    int deleteAll(Match match);
 
 
     // functions find the positions of parent and children of item
@@ -36,6 +83,7 @@ public:
     T *m_heap;  // array that holds heap objects
     int m_heapSize; // number of items in heap
     int m_heapCap;  // max capacity of heap
+    HeapSums<T> m_sums; // sums of items in heap
 
     bool (*compare)(const T&, const T&) ;   // comparison operator
 
@@ -66,6 +114,10 @@ public:
     // adds the item given in the parameter to the MedianHeap
     void insert(const T& item) ;
 
+    // adds item if there is room and returns true, returns false if full
+    // (see BoundedMedianHeap for other ways of handling a full heap)
+    bool tryInsert(const T& item) noexcept(is_nothrow_copy_constructible<T>::value && is_nothrow_copy_assignable<T>::value) ;
+
     // returns a copy of the median key object
     T getMedian() ;
 
@@ -80,6 +132,12 @@ public:
     void findMin(); // finds new min
     void findMax(); // finds new max
 
+    // deletes every item pred returns true for, returns number deleted
+    int deleteMany(bool (*pred) (const T&)) ;
+
+    // deletes every item from low to high inclusive, returns number deleted
+    int deleteMany(const T& low, const T& high) ;
+
     void balance();    // checks if MedianHeap needs to be rebalanced
 
     // prints out the contents of the MedianHeap including the positions of each 
@@ -92,11 +150,42 @@ public:
     // returns the number of items in the min heap
     int minHeapSize() ;
 
+    // returns the mean of every item, for number types only
+    double getMean() ;
+
+    // returns the mean of the items in the max heap, the lower half
+    double getLowerMean() ;
+
+    // returns the mean of the items in the min heap, the upper half
+    double getUpperMean() ;
+
+    // returns the population variance of the items in the max heap
+    double getLowerVariance() ;
+
+    // returns the population variance of the items in the min heap
+    double getUpperVariance() ;
+
     T locateInMaxHeap(int pos) ;
 
     T locateInMinHeap(int pos) ;
 
 private:
+    // writes and loads both heap arrays whole for its base images
+    template <typename U> friend class JournaledMedianHeap;
+
+    // deletes matching items from both heaps then rebalances once
+    template <typename Match>
+    int deleteMatching(Match match);
+
+    // matches items that are not less than low and not greater than high
+    struct InRange {
+        const T *low;
+        const T *high;
+        bool (*less) (const T&, const T&);
+        bool (*greater) (const T&, const T&);
+        bool operator()(const T& item) const { return !less(item, *low) && !greater(item, *high); }
+    };
+
     Heap<T> *minHeap;    // min heap object
     Heap<T> *maxHeap;    // max heap object
 
@@ -127,6 +216,7 @@ Heap<T>::Heap(const Heap<T>& other) {
     m_heapCap = other.m_heapCap;
     m_heapSize = other.m_heapSize;
     compare = other.compare;
+    m_sums = other.m_sums;
 
     // allocates memory for new heap
     m_heap = new T[m_heapCap+1];
@@ -159,6 +249,7 @@ const Heap<T>& Heap<T>::operator=(const Heap<T>& rhs) {
     m_heapCap = rhs.m_heapCap;
     m_heapSize = rhs.m_heapSize;
     compare = rhs.compare;
+    m_sums = rhs.m_sums;
 
     // allocates memory for lhs heap
     m_heap = new T[m_heapCap+1];
@@ -182,30 +273,29 @@ void Heap<T>::insert(const T& item) {
     else {
         m_heapSize++;
         m_heap[m_heapSize] = item;
+        m_sums.add(item);
         // call bubbleUp to check if item is in correct position
         bubbleUp(m_heapSize);
     }
 }
 
 // checks if inserted item is in correct position and if not, bubbles up
+// parents are moved down into the hole and item is written once at the end
 template <typename T>
 void Heap<T>::bubbleUp(int pos) {
-    int pIndex; // index of parent node
-    // if not the root of the heap
-    if(pos != 1){
-        // find parent index
-        pIndex = parent(pos);
-        // if node violates heap condition, swap with parent node
-        if(compare(m_heap[pos], m_heap[pIndex])){
-            swap(m_heap[pos], m_heap[pIndex]);
-            bubbleUp(pIndex);
-        }
+    T item = m_heap[pos];
+    // while not the root and item violates heap condition with parent
+    while(pos != 1 && compare(item, m_heap[parent(pos)])){
+        m_heap[pos] = m_heap[parent(pos)];
+        pos = parent(pos);
     }
+    m_heap[pos] = item;
 }
 
 // removes item from heap at the specified position
 template <typename T> 
 void Heap<T>::deleteH(int pos) {
+    m_sums.remove(m_heap[pos]);
     // if position specified is at end of array
     if(pos == m_heapSize){
         m_heapSize--;
@@ -232,26 +322,35 @@ void Heap<T>::deleteH(int pos) {
 }
 
 // checks if item is in correct position, and if not trickles down
-template <typename T> 
+// uses the bottom up method: the hole at pos is first moved all the way to a
+// leaf along the children that come first, which takes one compare per level,
+// then item is bubbled up from there. Items moved into the hole usually come
+// from the bottom of the heap, so they rarely go back up more than a level.
+template <typename T>
 void Heap<T>::trickleDown(int pos) {
-    // determine indices of children
-    int l = left(pos);
-    int r = right(pos);
-    int x = pos;    // will hold swap index
-
-    // if left child is in violation with item and condition
-    if(l <= m_heapSize && compare(m_heap[l], m_heap[pos])){
-        x = l;
+    T item = m_heap[pos];
+    int hole = pos;
+    int c = left(hole);
+
+    // while hole has two children, pick one without branching on the result
+    while(c < m_heapSize){
+        c += (int)compare(m_heap[c+1], m_heap[c]);
+        m_heap[hole] = m_heap[c];
+        hole = c;
+        c = left(hole);
     }
-    // if right child is either greater than or less than left
-    if(r <= m_heapSize && compare(m_heap[r], m_heap[x])) {
-        x = r;
+    // last parent may have only a left child
+    if(c == m_heapSize){
+        m_heap[hole] = m_heap[c];
+        hole = c;
     }
-    // if swap index was changed from pos, swap
-    if (x != pos){
-        swap(m_heap[pos], m_heap[x]);
-        trickleDown(x);
+
+    // bubble item up from the leaf, but not above pos
+    while(hole != pos && compare(item, m_heap[parent(hole)])){
+        m_heap[hole] = m_heap[parent(hole)];
+        hole = parent(hole);
     }
+    m_heap[hole] = item;
 }
 
 // swaps the two passed in items with one another
@@ -264,6 +363,94 @@ void Heap<T>::swap(T &v1, T &v2) {
     v2 = temp;
 }
 
+// puts item in place of the root and trickles it down, returns the old root
+// heap must not be empty
+template <typename T>
+T Heap<T>::replaceTop(const T& item) {
+    T top = m_heap[1];
+    m_heap[1] = item;
+    m_sums.remove(top);
+    m_sums.add(item);
+    trickleDown(1);
+    return top;
+}
+
+// same result as insert(item) followed by removing the root, but takes a single
+// trickleDown, and none at all if item would end up as the root
+template <typename T>
+T Heap<T>::pushPop(const T& item) {
+    // if item would be the new root it comes straight back out
+    if(m_heapSize == 0 || !compare(m_heap[1], item)){
+        return item;
+    }
+    return replaceTop(item);
+}
+
+// restores heap order over the whole array by trickling down every parent,
+// last parent first, which takes O(n) time. Items may have been written into
+// the array directly, so the sums are counted again too
+template <typename T>
+void Heap<T>::buildHeap() {
+    m_sums.clear();
+    for (int i=1; i <= m_heapSize; i++){
+        m_sums.add(m_heap[i]);
+    }
+    for (int i = parent(m_heapSize); i >= 1; i--){
+        trickleDown(i);
+    }
+}
+
+// scans heap once and deletes matching items in place with deleteH. Once so
+// many have been deleted that the sifts would cost more than rebuilding, the
+// rest of the array is compacted and buildHeap is run instead
+template <typename T>
+template <typename Match>
+int Heap<T>::deleteAll(Match match) {
+    // each deleteH costs about log n, buildHeap about n
+    int logN = 1;
+    while ((1 << logN) < m_heapSize){
+        logN++;
+    }
+    int limit = m_heapSize / logN;
+
+    int removed = 0;
+    int i = 1;
+    while (i <= m_heapSize){
+        if (!match(m_heap[i])){
+            i++;
+        }
+        else if (removed >= limit){
+            // keep the non matching items from i on and rebuild
+            int j = i;
+            for (int k = i; k <= m_heapSize; k++){
+                if (match(m_heap[k])){
+                    removed++;
+                }
+                else {
+                    m_heap[j] = m_heap[k];
+                    j++;
+                }
+            }
+            m_heapSize = j - 1;
+            buildHeap();
+            return removed;
+        }
+        else {
+            // trim matches off the end first, so the item deleteH moves into
+            // i doesn't match and can't bubble up past the scan
+            while (m_heapSize > i && match(m_heap[m_heapSize])){
+                m_sums.remove(m_heap[m_heapSize]);
+                m_heapSize--;
+                removed++;
+            }
+            // item now at i is checked again on the next pass
+            deleteH(i);
+            removed++;
+        }
+    }
+    return removed;
+}
+
 //********************** MedianHeap Class *********************************
 
 // constructor for MedianHeap class
@@ -346,6 +533,9 @@ int MedianHeap<T>::capacity() {
     return m_capacity;
 }
 
+// adds item to the half it belongs in. If that half already has the extra
+// item, item is pushed into it and its root popped across with pushPop, so
+// the heaps never need a separate balance()
 template <typename T>
 void MedianHeap<T>::insert(const T& item) {
     // if MedianHeap is full throw out of range error
@@ -358,45 +548,44 @@ void MedianHeap<T>::insert(const T& item) {
         minHeap->insert(item);
         m_min = item;
         m_max = item;
+        return;
     }
-    // if there is one item in MedianHeap
-    else if(size() == 1){
-        // if the item is less than median
-        T med = getMedian();
-        if(less(item, med)){
-            // insert into the max Heap and change min
-            maxHeap->insert(item);
-            m_min = item;
+    // if the item is less than median it belongs in the maxHeap
+    if(less(item, getMedian())){
+        if(maxHeap->m_heapSize > minHeap->m_heapSize){
+            minHeap->insert(maxHeap->pushPop(item));
         }
-        // if the item is greater than the median
-        else{
-            // insert the curr median into the maxHeap, and delete it from minHeap
-            maxHeap->insert(minHeap->m_heap[1]);
-            minHeap->deleteH(1);
-            // insert item into minHeap and change max
-            minHeap->insert(item);
-            m_max = item;
+        else {
+            maxHeap->insert(item);
         }
+        // check if min needs to be changed
+        if(less(item, m_min)) {m_min = item;}
     }
-    // more than one item in MedianHeap
+    // if item is greater than median it belongs in the minHeap
     else {
-        // if the item is less than median
-        if(less(item, getMedian())){
-            // insert into the maxHeap
-            maxHeap->insert(item);
-            // check if min needs to be changed
-            if(less(item, m_min)) {m_min = item;}
-        } 
-        // if item is greater than median insert in min heap
+        if(minHeap->m_heapSize > maxHeap->m_heapSize){
+            maxHeap->insert(minHeap->pushPop(item));
+        }
         else {
             minHeap->insert(item);
-            // check if max needs to be changed
-            if(greater(item, m_max)) {m_max = item;}
         }
-        balance();
+        // check if max needs to be changed
+        if(greater(item, m_max)) {m_max = item;}
     }
 }
 
+// same as insert but reports a full MedianHeap by returning false instead of
+// throwing. Once there is room only copying T can throw, so it is noexcept
+// for types whose copies can't, given comparisons that don't throw either
+template <typename T>
+bool MedianHeap<T>::tryInsert(const T& item) noexcept(is_nothrow_copy_constructible<T>::value && is_nothrow_copy_assignable<T>::value) {
+    if(size() == capacity()){
+        return false;
+    }
+    insert(item);
+    return true;
+}
+
 // returns a copy of the median key object
 template <typename T>
 T MedianHeap<T>::getMedian() {
@@ -486,12 +675,18 @@ bool MedianHeap<T>::deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&
 }
 
 // called when min is deleted, finds the new min
+// the smallest item in the maxHeap is one of its leaves
 template <typename T>
 void MedianHeap<T>::findMin() {
+    // if maxHeap is empty the only item left is the root of minHeap
+    if(maxHeap->m_heapSize == 0){
+        m_min = minHeap->m_heap[1];
+        return;
+    }
     // create temp var set it equal to root of maxHeap
     T temp = maxHeap->m_heap[1];
-    // iterate through maxHeap and find smallest value
-    for(int i=1; i <= maxHeap->m_heapSize; i++){
+    // iterate through leaves of maxHeap and find smallest value
+    for(int i = maxHeap->m_heapSize/2 + 1; i <= maxHeap->m_heapSize; i++){
         // if current item is less than temp, reassign temp
         if(less(maxHeap->m_heap[i], temp) ){
             temp = maxHeap->m_heap[i];
@@ -501,13 +696,19 @@ void MedianHeap<T>::findMin() {
 }
 
 // called when max is deleted, finds the new max
+// the largest item in the minHeap is one of its leaves
 template <typename T>
 void MedianHeap<T>::findMax() {
+    // if minHeap is empty the only item left is the root of maxHeap
+    if(minHeap->m_heapSize == 0){
+        m_max = maxHeap->m_heap[1];
+        return;
+    }
     // create temp var set it equal to root of minHeap
     T temp = minHeap->m_heap[1];
-    // iterate through minHeap and find largest value
-    for(int i=1; i <= minHeap->m_heapSize; i++){
-        // if current item is less than temp, reassign temp
+    // iterate through leaves of minHeap and find largest value
+    for(int i = minHeap->m_heapSize/2 + 1; i <= minHeap->m_heapSize; i++){
+        // if current item is greater than temp, reassign temp
         if(greater(minHeap->m_heap[i], temp) ){
             temp = minHeap->m_heap[i];
         }
@@ -515,6 +716,78 @@ void MedianHeap<T>::findMax() {
     m_max = temp; // assign max to tmep val
 }
 
+// deletes every item pred returns true for
+template <typename T>
+int MedianHeap<T>::deleteMany(bool (*pred) (const T&)) {
+    return deleteMatching(pred);
+}
+
+// deletes every item from low to high inclusive
+template <typename T>
+int MedianHeap<T>::deleteMany(const T& low, const T& high) {
+    InRange inRange;
+    inRange.low = &low;
+    inRange.high = &high;
+    inRange.less = less;
+    inRange.greater = greater;
+    return deleteMatching(inRange);
+}
+
+// removes matches from each heap in one pass, then evens out the heaps and
+// finds the new min and max once for the whole batch
+template <typename T>
+template <typename Match>
+int MedianHeap<T>::deleteMatching(Match match) {
+    int removed = maxHeap->deleteAll(match) + minHeap->deleteAll(match);
+    if (removed == 0 || size() == 0){
+        return removed;
+    }
+
+    // number of roots that would have to move from one heap to the other
+    int diff = maxHeap->m_heapSize - minHeap->m_heapSize;
+    int moves = (diff > 0 ? diff : -diff) / 2;
+
+    int logN = 1;
+    while ((1 << logN) < size()){
+        logN++;
+    }
+    if (moves * logN <= size()){
+        // few enough moves to do them one root at a time
+        for (int i=0; i < moves; i++){
+            balance();
+        }
+    }
+    else {
+        // gather every item, split them at the median with nth_element,
+        // then refill both arrays and rebuild both heaps
+        int n = size();
+        int lowerSize = n - n/2;
+        T *all = new T[n];
+        for (int i=0; i < maxHeap->m_heapSize; i++){
+            all[i] = maxHeap->m_heap[i+1];
+        }
+        for (int i=0; i < minHeap->m_heapSize; i++){
+            all[maxHeap->m_heapSize + i] = minHeap->m_heap[i+1];
+        }
+        nth_element(all, all + lowerSize, all + n, less);
+        for (int i=0; i < lowerSize; i++){
+            maxHeap->m_heap[i+1] = all[i];
+        }
+        for (int i=lowerSize; i < n; i++){
+            minHeap->m_heap[i - lowerSize + 1] = all[i];
+        }
+        maxHeap->m_heapSize = lowerSize;
+        minHeap->m_heapSize = n - lowerSize;
+        maxHeap->buildHeap();
+        minHeap->buildHeap();
+        delete[] all;
+    }
+
+    findMin();
+    findMax();
+    return removed;
+}
+
 template <typename T>
 void MedianHeap<T>::balance() {
     // if max heap size is greater than min heap size by more than one
@@ -575,6 +848,51 @@ int MedianHeap<T>::minHeapSize() {
     return minHeap->m_heapSize;
 }
 
+// returns the mean of every item from the sums both heaps keep
+template <typename T>
+double MedianHeap<T>::getMean() {
+    if(size() == 0){
+        throw out_of_range("The MedianHeap is empty.");
+    }
+    return (maxHeap->m_sums.total() + minHeap->m_sums.total()) / size();
+}
+
+// returns the mean of the max heap
+template <typename T>
+double MedianHeap<T>::getLowerMean() {
+    if(maxHeap->m_heapSize == 0){
+        throw out_of_range("The max heap is empty.");
+    }
+    return maxHeap->m_sums.mean();
+}
+
+// returns the mean of the min heap
+template <typename T>
+double MedianHeap<T>::getUpperMean() {
+    if(minHeap->m_heapSize == 0){
+        throw out_of_range("The min heap is empty.");
+    }
+    return minHeap->m_sums.mean();
+}
+
+// returns the variance of the max heap, worked out from its shifted sums
+template <typename T>
+double MedianHeap<T>::getLowerVariance() {
+    if(maxHeap->m_heapSize == 0){
+        throw out_of_range("The max heap is empty.");
+    }
+    return maxHeap->m_sums.variance();
+}
+
+// returns the variance of the min heap, worked out from its shifted sums
+template <typename T>
+double MedianHeap<T>::getUpperVariance() {
+    if(minHeap->m_heapSize == 0){
+        throw out_of_range("The min heap is empty.");
+    }
+    return minHeap->m_sums.variance();
+}
+
 // returns a copy of the item in position pos in the max heap 
 template <typename T>
 T MedianHeap<T>::locateInMaxHeap(int pos) {
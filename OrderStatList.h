@@ -0,0 +1,438 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    OrderStatList.h
+*/
+
+#ifndef _ORDERSTATLIST_H_
+#define _ORDERSTATLIST_H_
+
+#include <iostream>
+#include <stdexcept>
+using namespace std;
+
+// OrderStatList is an alternative to MedianHeap built on an indexable skip list.
+// It has the same interface as MedianHeap, but because the items are kept in
+// sorted order it can also answer select(k) and rank(x) in O(log n).
+// All nodes live in flat arrays allocated once at construction, so there is
+// no per-insert allocation and links are ints instead of pointers.
+template <typename T>
+class OrderStatList {
+public:
+    // constructor for OrderStatList class
+    // must create an OrderStatList object capable of holding cap items
+    OrderStatList( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap=100 ) ;
+
+    // copy constructor
+    OrderStatList(const OrderStatList<T>& otherL) ;
+
+    // destructor
+    ~OrderStatList() ;
+
+    // overloaded assignment operator
+    const OrderStatList<T>& operator=(const OrderStatList<T>& rhs) ;
+
+    // returns the total number of items in the OrderStatList
+    int size() ;
+
+    // returns the maximum number of items that can be stored in the OrderStatList
+    int capacity() ;
+
+    // adds the item given in the parameter to the OrderStatList
+    void insert(const T& item) ;
+
+    // returns a copy of the median key object, same median as MedianHeap
+    T getMedian() ;
+
+    // returns a copy of the minimum key object
+    T getMin() ;
+
+    // returns a copy of the maximum key object
+    T getMax() ;
+
+    // deletes specified item from OrderStatList, returns true if found and false if unfound
+    bool deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) ;
+
+    // returns a copy of the k-th smallest item, k goes from 1 to size()
+    T select(int k) ;
+
+    // returns the number of items strictly less than x
+    // (ex. how many samples are below a threshold)
+    int rank(const T& x) ;
+
+    // prints out the contents of the OrderStatList in sorted order
+    void dump() ;
+
+    static const int MAX_LEVEL = 16;   // max number of levels in skip list
+    static const int NIL = -1;         // marks the end of a level
+
+private:
+    int randomLevel();  // picks level of new node, each level has 1/4 chance
+    int allocNode();    // takes a node off the free list
+    void freeNode(int node);    // puts a node back on the free list
+    void copyFrom(const OrderStatList<T>& other);  // deep copies other into host
+
+    // functions find the next node and width of link for node x at level lvl
+    int& next(int x, int lvl) { return m_next[x*MAX_LEVEL + lvl]; }
+    int& width(int x, int lvl) { return m_width[x*MAX_LEVEL + lvl]; }
+
+    T *m_keys;      // array that holds items, node 0 is the head
+    int *m_next;    // index of next node at each level
+    int *m_width;   // number of positions each link skips over
+    int *m_nodeLevel;   // number of levels each node is on
+    int *m_free;    // stack of unused node indices
+    int m_freeTop;  // number of nodes on free stack
+
+    int m_level;    // current number of levels in use
+    int m_size;     // number of items in list
+    int m_capacity; // capacity of list
+    unsigned int m_seed;    // state for randomLevel
+
+    bool (*less) (const T&, const T&);
+    bool (*greater) (const T&, const T&);
+};
+
+// constructor for OrderStatList class
+// allocates all node arrays up front and sets up empty head node
+template <typename T>
+OrderStatList<T>::OrderStatList( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap) {
+    m_capacity = cap;
+    m_size = 0;
+    m_level = 1;
+    m_seed = 2463534242u;
+
+    m_keys = new T[cap+1];
+    m_next = new int[(cap+1) * MAX_LEVEL];
+    m_width = new int[(cap+1) * MAX_LEVEL];
+    m_nodeLevel = new int[cap+1];
+    m_free = new int[cap];
+
+    // head node is on every level and points to nothing
+    for (int l=0; l < MAX_LEVEL; l++){
+        next(0, l) = NIL;
+        width(0, l) = 0;
+    }
+    m_nodeLevel[0] = MAX_LEVEL;
+
+    // every other node starts on the free stack
+    m_freeTop = 0;
+    for (int i=cap; i >= 1; i--){
+        m_free[m_freeTop++] = i;
+    }
+
+    less = lt;
+    greater = gt;
+}
+
+// OrderStatList class copy constructor
+// creates a deep copy of the passed in OrderStatList object
+template <typename T>
+OrderStatList<T>::OrderStatList(const OrderStatList<T>& otherL) {
+    copyFrom(otherL);
+}
+
+// OrderStatList class destructor
+// deallocates any dynamically allocated memory
+template <typename T>
+OrderStatList<T>::~OrderStatList() {
+    delete[] m_keys;
+    delete[] m_next;
+    delete[] m_width;
+    delete[] m_nodeLevel;
+    delete[] m_free;
+    m_keys = NULL;
+    m_next = NULL;
+    m_width = NULL;
+    m_nodeLevel = NULL;
+    m_free = NULL;
+
+    m_size = 0;
+    m_capacity = 0;
+}
+
+// OrderStatList class overloaded assignment operator
+// deallocates memory of the host object and copies rhs into host
+template <typename T>
+const OrderStatList<T>& OrderStatList<T>::operator=(const OrderStatList<T>& rhs) {
+    // checks first for self-assignment, if true returns object
+    if(this == &rhs){
+        return *this;
+    }
+
+    delete[] m_keys;
+    delete[] m_next;
+    delete[] m_width;
+    delete[] m_nodeLevel;
+    delete[] m_free;
+    copyFrom(rhs);
+
+    return *this;
+}
+
+// allocates arrays the same size as other's and copies every node over
+template <typename T>
+void OrderStatList<T>::copyFrom(const OrderStatList<T>& other) {
+    m_capacity = other.m_capacity;
+    m_size = other.m_size;
+    m_level = other.m_level;
+    m_seed = other.m_seed;
+    m_freeTop = other.m_freeTop;
+    less = other.less;
+    greater = other.greater;
+
+    m_keys = new T[m_capacity+1];
+    m_next = new int[(m_capacity+1) * MAX_LEVEL];
+    m_width = new int[(m_capacity+1) * MAX_LEVEL];
+    m_nodeLevel = new int[m_capacity+1];
+    m_free = new int[m_capacity];
+
+    for (int i=0; i <= m_capacity; i++){
+        m_keys[i] = other.m_keys[i];
+        m_nodeLevel[i] = other.m_nodeLevel[i];
+    }
+    for (int i=0; i < (m_capacity+1) * MAX_LEVEL; i++){
+        m_next[i] = other.m_next[i];
+        m_width[i] = other.m_width[i];
+    }
+    for (int i=0; i < m_freeTop; i++){
+        m_free[i] = other.m_free[i];
+    }
+}
+
+// returns the total number of items in the OrderStatList
+template <typename T>
+int OrderStatList<T>::size() {
+    return m_size;
+}
+
+// returns the maximum number of items that can be stored in the OrderStatList
+template <typename T>
+int OrderStatList<T>::capacity() {
+    return m_capacity;
+}
+
+// picks a random level for a new node using xorshift
+template <typename T>
+int OrderStatList<T>::randomLevel() {
+    int lvl = 1;
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+    unsigned int bits = m_seed;
+    // each pair of bits that is zero adds a level
+    while (lvl < MAX_LEVEL && (bits & 3) == 0){
+        lvl++;
+        bits >>= 2;
+    }
+    return lvl;
+}
+
+// takes the next unused node off the free stack
+template <typename T>
+int OrderStatList<T>::allocNode() {
+    m_freeTop--;
+    return m_free[m_freeTop];
+}
+
+// returns node to the free stack
+template <typename T>
+void OrderStatList<T>::freeNode(int node) {
+    m_free[m_freeTop] = node;
+    m_freeTop++;
+}
+
+// inserts item after every item it is not less than
+template <typename T>
+void OrderStatList<T>::insert(const T& item) {
+    // if OrderStatList is full throw out of range error
+    if(m_size == m_capacity){
+        throw out_of_range("The OrderStatList is full. Cannot insert item.");
+    }
+
+    int update[MAX_LEVEL];  // last node before item on each level
+    int rankAt[MAX_LEVEL];  // position of update node on each level
+    int x = 0;
+    int pos = 0;
+
+    // walk down from the top level, moving right while next is not greater than item
+    for (int l = m_level - 1; l >= 0; l--){
+        while (next(x, l) != NIL && !less(item, m_keys[next(x, l)])){
+            pos += width(x, l);
+            x = next(x, l);
+        }
+        update[l] = x;
+        rankAt[l] = pos;
+    }
+
+    int lvl = randomLevel();
+    // new levels start at the head
+    if (lvl > m_level){
+        for (int l = m_level; l < lvl; l++){
+            update[l] = 0;
+            rankAt[l] = 0;
+            next(0, l) = NIL;
+        }
+        m_level = lvl;
+    }
+
+    // link new node in at each of its levels
+    int node = allocNode();
+    int p = pos + 1;    // position new node ends up in
+    m_keys[node] = item;
+    m_nodeLevel[node] = lvl;
+    for (int l=0; l < lvl; l++){
+        next(node, l) = next(update[l], l);
+        next(update[l], l) = node;
+        // split old link width between update node and new node
+        width(node, l) = width(update[l], l) - (p - rankAt[l]) + 1;
+        width(update[l], l) = p - rankAt[l];
+    }
+    // links above new node now skip one more item
+    for (int l = lvl; l < m_level; l++){
+        if (next(update[l], l) != NIL){
+            width(update[l], l)++;
+        }
+    }
+    m_size++;
+}
+
+// returns a copy of the median key object
+// for an even number of items this is the lower middle, same as MedianHeap
+template <typename T>
+T OrderStatList<T>::getMedian() {
+    if(m_size == 0){
+        throw out_of_range("The OrderStatList is empty.");
+    }
+    return select((m_size + 1) / 2);
+}
+
+// returns a copy of the min key object
+template <typename T>
+T OrderStatList<T>::getMin() {
+    if(m_size == 0){
+        throw out_of_range("The OrderStatList is empty.");
+    }
+    return m_keys[next(0, 0)];
+}
+
+// returns a copy of the max key object
+template <typename T>
+T OrderStatList<T>::getMax() {
+    if(m_size == 0){
+        throw out_of_range("The OrderStatList is empty.");
+    }
+    return select(m_size);
+}
+
+// looks for givenItem in OrderStatList and if found deletes item and returns true
+// if unfound, OrderStatList is unchanged and returns false
+template <typename T>
+bool OrderStatList<T>::deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) {
+    // if the OrderStatList is empty throw out of range error
+    if(m_size == 0) {
+        throw out_of_range("The list is empty, cannot remove item.");
+    }
+
+    int update[MAX_LEVEL];  // last node before candidate on each level
+    int x = 0;
+
+    // walk down to the last node that is less than givenItem
+    for (int l = m_level - 1; l >= 0; l--){
+        while (next(x, l) != NIL && less(m_keys[next(x, l)], givenItem)){
+            x = next(x, l);
+        }
+        update[l] = x;
+    }
+
+    // check each item that compares equal to givenItem for a match
+    int cand = next(update[0], 0);
+    while (cand != NIL && !greater(m_keys[cand], givenItem)){
+        if (equalTo(m_keys[cand], givenItem)){
+            // copy item into givenItem then unlink node on every level
+            givenItem = m_keys[cand];
+            for (int l=0; l < m_level; l++){
+                if (next(update[l], l) == cand){
+                    width(update[l], l) += width(cand, l) - 1;
+                    next(update[l], l) = next(cand, l);
+                }
+                else if (next(update[l], l) != NIL){
+                    width(update[l], l)--;
+                }
+            }
+            freeNode(cand);
+            m_size--;
+
+            // drop empty levels
+            while (m_level > 1 && next(0, m_level - 1) == NIL){
+                m_level--;
+            }
+            return true;
+        }
+        // candidate becomes the predecessor on its levels
+        for (int l=0; l < m_nodeLevel[cand]; l++){
+            update[l] = cand;
+        }
+        cand = next(cand, 0);
+    }
+    // if unfound
+    return false;
+}
+
+// returns a copy of the k-th smallest item
+template <typename T>
+T OrderStatList<T>::select(int k) {
+    // if k is invalid, throw error
+    if(k < 1 || k > m_size){
+        throw out_of_range("Rank specified is invalid or out of range.");
+    }
+    int x = 0;
+    int pos = 0;
+    // move right on each level as long as it doesn't go past k
+    for (int l = m_level - 1; l >= 0; l--){
+        while (next(x, l) != NIL && pos + width(x, l) <= k){
+            pos += width(x, l);
+            x = next(x, l);
+        }
+    }
+    return m_keys[x];
+}
+
+// returns the number of items that are less than x
+template <typename T>
+int OrderStatList<T>::rank(const T& x) {
+    int node = 0;
+    int pos = 0;
+    for (int l = m_level - 1; l >= 0; l--){
+        while (next(node, l) != NIL && less(m_keys[next(node, l)], x)){
+            pos += width(node, l);
+            node = next(node, l);
+        }
+    }
+    return pos;
+}
+
+// prints out list data in sorted order
+template <typename T>
+void OrderStatList<T>::dump() {
+    cout << "... OrderStatList()::dump() ..." << endl;
+    cout << endl;
+    cout << "size = " << m_size << ", ";
+    cout << "capacity = " << m_capacity << ", ";
+    cout << "levels = " << m_level << endl;
+    int i = 1;
+    for (int x = next(0, 0); x != NIL; x = next(x, 0)){
+        cout << "List[" << i << "] = (" << m_keys[x] << ")" << endl;
+        i++;
+    }
+
+    cout << "--------------------------------" << endl;
+    if (m_size > 0){
+        cout << "min    = " << getMin() << endl;
+        cout << "median = " << getMedian() << endl;
+        cout << "max    = " << getMax() << endl;
+    }
+}
+
+#endif
@@ -0,0 +1,338 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    RangeMedian.h
+*/
+
+#ifndef _RANGEMEDIAN_H_
+#define _RANGEMEDIAN_H_
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// one-shot median of the items first ... last-1, the lower middle for an even
+// count, same as MedianHeap. The items are only read, never reordered.
+template <typename T>
+T median(const T* first, const T* last, bool (*lt) (const T&, const T&), int threads=0);
+
+// finds count quantiles of first ... last-1 together, out[i] gets the qs[i]
+// quantile using the nearest rank, same as ExternalMedian
+template <typename T>
+void quantiles(const T* first, const T* last, const double* qs, int count, T* out,
+               bool (*lt) (const T&, const T&), int threads=0);
+
+const int SELECT_SMALL = 1 << 14;       // ranges this small are finished with nth_element
+const int SELECT_SAMPLE = 1 << 14;      // most items sampled to choose pivots
+const int SELECT_MIN_CHUNK = 1 << 16;   // fewest items worth giving a thread
+
+// RangeSelect finds items at given sorted ranks without sorting. Each round
+// sorts a random sample and takes two pivots from it around every wanted
+// rank, so the items between them hold that rank with high probability. The
+// threads split the range, count how many items fall in each bucket between
+// and equal to the pivots, then copy out only the buckets holding a wanted
+// rank. The counting pass already keeps the items between each rank's two
+// pivots, so the copying pass is only needed when a rank misses them. Threads
+// share nothing but counts, so a round scales with memory bandwidth. A rank
+// landing in an equal bucket is a pivot and is done; the others repeat on
+// their bucket, about 1/40 of the range.
+template <typename T>
+class RangeSelect {
+public:
+    // a wanted rank, 0 for the smallest item, and where to put its item
+    struct Want {
+        long long rank;
+        T *out;
+        bool operator<(const Want& rhs) const { return rank < rhs.rank; }
+    };
+
+    // constructor, threads of 0 or less uses every core
+    RangeSelect( bool (*lt) (const T&, const T&), int threads ) ;
+
+    // fills in every want from items[0] ... items[n-1], wants sorted by rank
+    void select(const T* items, long long n, Want* wants, int count) ;
+
+private:
+    // bucket 2j holds items between pivots j-1 and j, bucket 2j+1 items equal to pivot j
+    int bucketOf(const T& item) ;
+    void countRange(const T* items, long long begin, long long end, long long* counts, vector<T>* kept) ;
+    void copyRange(const T* items, long long begin, long long end, T* out, const long long* offsets) ;
+    void choosePivots(const T* items, long long n, const Want* wants, int count) ;
+    void selectSmall(const T* items, long long n, Want* wants, int count) ;
+    long long random(long long n) ;     // random index from 0 to n-1
+
+    vector<T> m_pivots;     // pivots of the current round, sorted and distinct
+    vector<char> m_expected;    // buckets between two pivots of the same rank
+    unsigned long long m_seed;  // state of the sample generator
+    int m_threads;
+    bool (*less) (const T&, const T&);
+};
+
+// constructor for RangeSelect
+template <typename T>
+RangeSelect<T>::RangeSelect( bool (*lt) (const T&, const T&), int threads ) {
+    if (threads <= 0){
+        threads = (int)thread::hardware_concurrency();
+    }
+    m_threads = max(threads, 1);
+    m_seed = 0x9E3779B97F4A7C15ULL;
+    less = lt;
+}
+
+// xorshift, good enough for picking a sample and always the same for a range
+template <typename T>
+long long RangeSelect<T>::random(long long n) {
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 7;
+    m_seed ^= m_seed << 17;
+    return (long long)(m_seed % (unsigned long long)n);
+}
+
+// returns bucket of item, found by binary search of the pivots
+template <typename T>
+int RangeSelect<T>::bucketOf(const T& item) {
+    int j = (int)(lower_bound(m_pivots.begin(), m_pivots.end(), item, less) - m_pivots.begin());
+    if (j < (int)m_pivots.size() && !less(item, m_pivots[j])){
+        return 2 * j + 1;
+    }
+    return 2 * j;
+}
+
+// counts items begin ... end-1 of each bucket into counts and copies the
+// items of expected buckets into kept, both are filled locally first so
+// threads don't write to the same cache lines
+template <typename T>
+void RangeSelect<T>::countRange(const T* items, long long begin, long long end, long long* counts, vector<T>* kept) {
+    int buckets = 2 * (int)m_pivots.size() + 1;
+    vector<long long> local(buckets, 0);
+    vector< vector<T> > localKept(buckets);
+    for (long long i = begin; i < end; i++){
+        int b = bucketOf(items[i]);
+        local[b]++;
+        if (m_expected[b]){
+            localKept[b].push_back(items[i]);
+        }
+    }
+    for (int b=0; b < buckets; b++){
+        counts[b] = local[b];
+        kept[b].swap(localKept[b]);
+    }
+}
+
+// copies items begin ... end-1 of wanted buckets that weren't kept into out
+// offsets[b] is where this thread's part of bucket b starts, -1 to skip b
+template <typename T>
+void RangeSelect<T>::copyRange(const T* items, long long begin, long long end, T* out, const long long* offsets) {
+    vector<long long> next(offsets, offsets + 2 * m_pivots.size() + 1);
+    for (long long i = begin; i < end; i++){
+        int b = bucketOf(items[i]);
+        if (next[b] >= 0){
+            out[next[b]++] = items[i];
+        }
+    }
+}
+
+// sorts a sample and takes the items a bit below and above where each rank
+// should fall in it, the gap is about three standard deviations of that spot
+template <typename T>
+void RangeSelect<T>::choosePivots(const T* items, long long n, const Want* wants, int count) {
+    int samples = (int)min((long long)SELECT_SAMPLE, n / 4);
+    vector<T> sample(samples);
+    for (int i=0; i < samples; i++){
+        sample[i] = items[random(n)];
+    }
+    sort(sample.begin(), sample.end(), less);
+
+    int gap = (int)(1.5 * sqrt((double)samples)) + 1;
+    vector<T> bounds;
+    for (int i=0; i < count; i++){
+        int at = (int)((double)wants[i].rank * samples / n);
+        bounds.push_back(sample[max(at - gap, 0)]);
+        bounds.push_back(sample[min(at + gap, samples - 1)]);
+    }
+    // wants are sorted so the bounds already are, only repeats need removing
+    m_pivots.clear();
+    m_pivots.push_back(bounds[0]);
+    for (size_t i=1; i < bounds.size(); i++){
+        if (less(m_pivots.back(), bounds[i])){
+            m_pivots.push_back(bounds[i]);
+        }
+    }
+
+    // between buckets from a rank's low pivot up to its high pivot are expected
+    m_expected.assign(2 * m_pivots.size() + 1, 0);
+    for (int i=0; i < count; i++){
+        int low = (int)(lower_bound(m_pivots.begin(), m_pivots.end(), bounds[2 * i], less) - m_pivots.begin());
+        int high = (int)(lower_bound(m_pivots.begin(), m_pivots.end(), bounds[2 * i + 1], less) - m_pivots.begin());
+        for (int j = low + 1; j <= high; j++){
+            m_expected[2 * j] = 1;
+        }
+    }
+}
+
+// copies a small range and finds each rank with nth_element, every call
+// only looks at the items from the previous rank up
+template <typename T>
+void RangeSelect<T>::selectSmall(const T* items, long long n, Want* wants, int count) {
+    vector<T> copied(items, items + n);
+    typename vector<T>::iterator from = copied.begin();
+    for (int i=0; i < count; i++){
+        typename vector<T>::iterator at = copied.begin() + wants[i].rank;
+        if (at != from || i == 0){
+            nth_element(from, at, copied.end(), less);
+        }
+        *(wants[i].out) = *at;
+        from = at;
+    }
+}
+
+// one round of sampling, counting and copying, then repeats on each bucket
+// that still holds a wanted rank
+template <typename T>
+void RangeSelect<T>::select(const T* items, long long n, Want* wants, int count) {
+    if (n <= SELECT_SMALL){
+        selectSmall(items, n, wants, count);
+        return;
+    }
+    choosePivots(items, n, wants, count);
+    int buckets = 2 * (int)m_pivots.size() + 1;
+
+    // don't start threads that would each get a tiny chunk
+    int threads = (int)min((long long)m_threads, n / SELECT_MIN_CHUNK);
+    threads = max(threads, 1);
+    long long chunk = (n + threads - 1) / threads;
+    vector<long long> counts(threads * buckets);
+    vector< vector<T> > kept(threads * buckets);
+    vector<thread> workers;
+    for (int t=1; t < threads; t++){
+        workers.push_back(thread(&RangeSelect<T>::countRange, this, items, t * chunk,
+                                 min(n, (t + 1) * chunk), &counts[t * buckets], &kept[t * buckets]));
+    }
+    // this thread does the first chunk
+    countRange(items, 0, min(n, chunk), &counts[0], &kept[0]);
+    for (size_t i=0; i < workers.size(); i++){
+        workers[i].join();
+    }
+
+    // finds the bucket holding each rank, ranks in an equal bucket are done
+    vector<long long> start(buckets + 1, 0);
+    for (int b=0; b < buckets; b++){
+        start[b + 1] = start[b];
+        for (int t=0; t < threads; t++){
+            start[b + 1] += counts[t * buckets + b];
+        }
+    }
+    vector<int> bucketFor(count);
+    vector<long long> where(buckets, -1);   // where each wanted bucket starts in the copy
+    long long copySize = 0;
+    bool missed = false;    // true if a wanted bucket wasn't kept
+    int b = 0;
+    for (int i=0; i < count; i++){
+        while (start[b + 1] <= wants[i].rank){
+            b++;
+        }
+        bucketFor[i] = b;
+        if (b % 2 == 1){
+            *(wants[i].out) = m_pivots[b / 2];
+        } else if (where[b] < 0){
+            where[b] = copySize;
+            copySize += start[b + 1] - start[b];
+            missed = missed || !m_expected[b];
+        }
+    }
+    if (copySize == 0){
+        return;
+    }
+
+    // each thread's part of a bucket goes after the parts of earlier threads
+    vector<T> copied(copySize);
+    vector<long long> offsets(threads * buckets, -1);
+    for (int b=0; b < buckets; b++){
+        long long at = where[b];
+        for (int t=0; at >= 0 && t < threads; t++){
+            if (m_expected[b]){
+                copy(kept[t * buckets + b].begin(), kept[t * buckets + b].end(), copied.begin() + at);
+            } else {
+                offsets[t * buckets + b] = at;
+            }
+            at += counts[t * buckets + b];
+        }
+    }
+    kept.clear();
+    if (missed){
+        workers.clear();
+        for (int t=1; t < threads; t++){
+            workers.push_back(thread(&RangeSelect<T>::copyRange, this, items, t * chunk,
+                                     min(n, (t + 1) * chunk), &copied[0], &offsets[t * buckets]));
+        }
+        copyRange(items, 0, min(n, chunk), &copied[0], &offsets[0]);
+        for (size_t i=0; i < workers.size(); i++){
+            workers[i].join();
+        }
+    }
+
+    // ranks become ranks within their bucket, then each bucket goes again
+    int i = 0;
+    while (i < count){
+        int first = i;
+        int b = bucketFor[i];
+        while (i < count && bucketFor[i] == b){
+            wants[i].rank -= start[b];
+            i++;
+        }
+        if (b % 2 == 0){
+            select(&copied[where[b]], start[b + 1] - start[b], wants + first, i - first);
+        }
+    }
+}
+
+// returns the median of first ... last-1
+template <typename T>
+T median(const T* first, const T* last, bool (*lt) (const T&, const T&), int threads) {
+    long long n = last - first;
+    if (n <= 0){
+        throw out_of_range("The range is empty.");
+    }
+    T result;
+    typename RangeSelect<T>::Want want;
+    want.rank = (n + 1) / 2 - 1;
+    want.out = &result;
+    RangeSelect<T> selector(lt, threads);
+    selector.select(first, n, &want, 1);
+    return result;
+}
+
+// finds count quantiles of first ... last-1 in the same rounds
+template <typename T>
+void quantiles(const T* first, const T* last, const double* qs, int count, T* out,
+               bool (*lt) (const T&, const T&), int threads) {
+    long long n = last - first;
+    if (n <= 0){
+        throw out_of_range("The range is empty.");
+    }
+    vector<typename RangeSelect<T>::Want> wants(count);
+    for (int i=0; i < count; i++){
+        if (qs[i] < 0 || qs[i] > 1){
+            throw out_of_range("Quantile must be from 0 to 1.");
+        }
+        long long k = (long long)(qs[i] * n);
+        if (k < qs[i] * n){
+            k++;
+        }
+        wants[i].rank = max(k, 1LL) - 1;
+        wants[i].out = out + i;
+    }
+    if (count == 0){
+        return;
+    }
+    sort(wants.begin(), wants.end());
+    RangeSelect<T> selector(lt, threads);
+    selector.select(first, n, &wants[0], count);
+}
+
+#endif
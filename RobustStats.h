@@ -0,0 +1,268 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    RobustStats.h
+*/
+
+#ifndef _ROBUSTSTATS_H_
+#define _ROBUSTSTATS_H_
+
+#include <iostream>
+#include <stdexcept>
+#include "OrderStatList.h"
+using namespace std;
+
+// RobustStats keeps the median, quartiles, interquartile range and median
+// absolute deviation of a set of items that are inserted and deleted one at a
+// time. Items live in an OrderStatList, so each quartile is one select in
+// O(log n). The deviations |x - median| aren't stored, since a new median
+// would change all of them. Instead the deviations of items below the median
+// and of items above it are two sorted lists read straight out of the list,
+// and the MAD is the middle of the two merged, found by binary search in
+// O(log^2 n). The MAD is remembered until the next insert or delete.
+// Medians and quartiles use the lower middle and nearest rank, same as
+// MedianHeap and ExternalMedian. T must support subtraction.
+template <typename T>
+class RobustStats {
+public:
+    // constructor for RobustStats class
+    RobustStats( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap=100 ) ;
+
+    // copy constructor
+    RobustStats(const RobustStats<T>& other) ;
+
+    // destructor
+    ~RobustStats() ;
+
+    // overloaded assignment operator
+    const RobustStats<T>& operator=(const RobustStats<T>& rhs) ;
+
+    // returns the total number of items in the RobustStats
+    int size() ;
+
+    // returns the maximum number of items that can be stored in the RobustStats
+    int capacity() ;
+
+    // adds the item given in the parameter to the RobustStats
+    void insert(const T& item) ;
+
+    // deletes specified item, returns true if found and false if unfound
+    bool deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) ;
+
+    // returns a copy of the median key object
+    T getMedian() ;
+
+    // returns a copy of the minimum key object
+    T getMin() ;
+
+    // returns a copy of the maximum key object
+    T getMax() ;
+
+    // returns the first quartile, the 0.25 quantile
+    T getLowerQuartile() ;
+
+    // returns the third quartile, the 0.75 quantile
+    T getUpperQuartile() ;
+
+    // returns the upper quartile minus the lower quartile
+    T getIQR() ;
+
+    // returns the median of |x - median| over every item x
+    T getMAD() ;
+
+    // prints out the items and statistics
+    void dump() ;
+
+private:
+    int rankFor(int quarters) ;   // nearest rank of the quarters/4 quantile
+    T lowDeviation(int i, const T& median, int medianRank) ;   // i-th smallest deviation below median
+    T highDeviation(int i, const T& median, int medianRank) ;  // i-th smallest deviation above median
+
+    OrderStatList<T> m_items;   // every item in sorted order
+    T m_mad;            // last MAD found
+    bool m_madValid;    // true if m_mad is still right
+    bool (*less) (const T&, const T&);
+};
+
+// constructor for RobustStats class
+template <typename T>
+RobustStats<T>::RobustStats( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap )
+    : m_items(lt, gt, cap) {
+    m_madValid = false;
+    less = lt;
+}
+
+// RobustStats class copy constructor
+template <typename T>
+RobustStats<T>::RobustStats(const RobustStats<T>& other) : m_items(other.m_items) {
+    m_mad = other.m_mad;
+    m_madValid = other.m_madValid;
+    less = other.less;
+}
+
+// RobustStats class destructor, the OrderStatList frees its own memory
+template <typename T>
+RobustStats<T>::~RobustStats() {
+    m_madValid = false;
+}
+
+// RobustStats class overloaded assignment operator
+template <typename T>
+const RobustStats<T>& RobustStats<T>::operator=(const RobustStats<T>& rhs) {
+    // checks first for self-assignment, if true returns object
+    if(this == &rhs){
+        return *this;
+    }
+    m_items = rhs.m_items;
+    m_mad = rhs.m_mad;
+    m_madValid = rhs.m_madValid;
+    less = rhs.less;
+    return *this;
+}
+
+// returns the total number of items in the RobustStats
+template <typename T>
+int RobustStats<T>::size() {
+    return m_items.size();
+}
+
+// returns the maximum number of items that can be stored in the RobustStats
+template <typename T>
+int RobustStats<T>::capacity() {
+    return m_items.capacity();
+}
+
+// adds item, OrderStatList throws if full
+template <typename T>
+void RobustStats<T>::insert(const T& item) {
+    m_items.insert(item);
+    m_madValid = false;
+}
+
+// looks for givenItem and if found deletes item and returns true
+template <typename T>
+bool RobustStats<T>::deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) {
+    bool found = m_items.deleteItem(givenItem, equalTo);
+    if (found){
+        m_madValid = false;
+    }
+    return found;
+}
+
+// returns a copy of the median
+template <typename T>
+T RobustStats<T>::getMedian() {
+    return m_items.getMedian();
+}
+
+// returns a copy of the min
+template <typename T>
+T RobustStats<T>::getMin() {
+    return m_items.getMin();
+}
+
+// returns a copy of the max
+template <typename T>
+T RobustStats<T>::getMax() {
+    return m_items.getMax();
+}
+
+// returns the smallest k with k/size() at least quarters/4
+template <typename T>
+int RobustStats<T>::rankFor(int quarters) {
+    int k = (int)(((long long)quarters * m_items.size() + 3) / 4);
+    return k < 1 ? 1 : k;
+}
+
+// returns the first quartile
+template <typename T>
+T RobustStats<T>::getLowerQuartile() {
+    if(size() == 0){
+        throw out_of_range("The RobustStats is empty.");
+    }
+    return m_items.select(rankFor(1));
+}
+
+// returns the third quartile
+template <typename T>
+T RobustStats<T>::getUpperQuartile() {
+    if(size() == 0){
+        throw out_of_range("The RobustStats is empty.");
+    }
+    return m_items.select(rankFor(3));
+}
+
+// returns the interquartile range
+template <typename T>
+T RobustStats<T>::getIQR() {
+    return getUpperQuartile() - getLowerQuartile();
+}
+
+// deviations of the median and items below it, i = 1 is the median itself
+template <typename T>
+T RobustStats<T>::lowDeviation(int i, const T& median, int medianRank) {
+    return median - m_items.select(medianRank - i + 1);
+}
+
+// deviations of items above the median, i = 1 is the next item up
+template <typename T>
+T RobustStats<T>::highDeviation(int i, const T& median, int medianRank) {
+    return m_items.select(medianRank + i) - median;
+}
+
+// returns the median absolute deviation
+// with low and high the two sorted deviation lists, it finds how many of the
+// k smallest deviations come from low: taking i is too few while the next low
+// deviation is smaller than the high deviation it would push out
+template <typename T>
+T RobustStats<T>::getMAD() {
+    if(size() == 0){
+        throw out_of_range("The RobustStats is empty.");
+    }
+    if (m_madValid){
+        return m_mad;
+    }
+    int n = m_items.size();
+    int p = (n + 1) / 2;    // rank of median, also how many low deviations
+    int k = (n + 1) / 2;    // rank of MAD among the deviations
+    T median = m_items.select(p);
+
+    int lo = k - (n - p) > 0 ? k - (n - p) : 0;
+    int hi = k < p ? k : p;
+    while (lo < hi){
+        int i = (lo + hi) / 2;
+        if (less(lowDeviation(i + 1, median, p), highDeviation(k - i, median, p))){
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+    // the k-th smallest is the larger of the last one taken from each list
+    if (lo == 0){
+        m_mad = highDeviation(k, median, p);
+    } else if (lo == k){
+        m_mad = lowDeviation(k, median, p);
+    } else {
+        T low = lowDeviation(lo, median, p);
+        T high = highDeviation(k - lo, median, p);
+        m_mad = less(low, high) ? high : low;
+    }
+    m_madValid = true;
+    return m_mad;
+}
+
+// prints out the items followed by the statistics
+template <typename T>
+void RobustStats<T>::dump() {
+    m_items.dump();
+    if (size() > 0){
+        cout << "q1     = " << getLowerQuartile() << endl;
+        cout << "q3     = " << getUpperQuartile() << endl;
+        cout << "iqr    = " << getIQR() << endl;
+        cout << "mad    = " << getMAD() << endl;
+    }
+}
+
+#endif
@@ -0,0 +1,625 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    SharedMedianHeap.h
+*/
+
+#ifndef _SHAREDMEDIANHEAP_H_
+#define _SHAREDMEDIANHEAP_H_
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <atomic>
+#include <cerrno>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+using namespace std;
+
+const unsigned int SHARED_HEAP_MAGIC = 0x53484d48;  // set once a segment is ready
+const int SHARED_OPEN_TRIES = 5000;     // waits of 1 ms for another process to finish creating
+
+// SharedMedianHeap is a MedianHeap that lives in a POSIX shared memory
+// segment, so every process that opens the same name inserts into and reads
+// one heap with nothing copied between them. The segment holds a header with
+// the sizes, min and max, followed by the max heap and min heap arrays. The
+// header finds the arrays by their offsets from the start of the segment,
+// never by pointers, since each process maps it at its own address. The
+// comparison functions are kept by each process for the same reason.
+//
+// Each call holds a robust, process shared mutex in the header. If a process
+// dies holding it, the next one to lock gets EOWNERDEAD and repairs the heap
+// before going on: both halves are split again around the median of what
+// they hold and heapified, and the min and max are found again. A size is
+// raised only after the slot it adds holds its item, and a removal fills the
+// gap before the size drops, so every item counted after a crash is one that
+// was inserted, never stale bytes. The op cut off by the crash may be lost
+// or only partly done, and since sifts move items through a hole, one item
+// of that half may be lost and another doubled in its place. insertMany
+// takes the lock once for a whole batch, for writers with many samples at a
+// time.
+//
+// The first process to open a name creates the segment with room for cap
+// items, later ones use the capacity it was made with. The segment stays
+// until removeSegment is called, even with no process attached. T is shared
+// as raw bytes, so it must be trivially copyable. Link with -pthread, and
+// -lrt on older systems.
+template <typename T>
+class SharedMedianHeap {
+    static_assert(is_trivially_copyable<T>::value, "SharedMedianHeap needs a trivially copyable type");
+public:
+    // constructor for SharedMedianHeap class, opens name or creates it
+    // with room for cap items if no process has yet
+    SharedMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&),
+                      const string& name, int cap=100 ) ;
+
+    // destructor, unmaps the segment but leaves it for other processes
+    ~SharedMedianHeap() ;
+
+    // deletes the segment name, processes that have it open keep using it
+    static bool removeSegment(const string& name) ;
+
+    // returns the total number of items in the SharedMedianHeap
+    int size() ;
+
+    // returns the maximum number of items that can be stored
+    int capacity() ;
+
+    // adds the item given in the parameter to the SharedMedianHeap
+    void insert(const T& item) ;
+
+    // adds count items under one lock, stops if full, returns number added
+    int insertMany(const T* batch, int count) ;
+
+    // returns a copy of the median key object
+    T getMedian() ;
+
+    // returns a copy of the minimum key object
+    T getMin() ;
+
+    // returns a copy of the maximum key object
+    T getMax() ;
+
+    // deletes specified item, returns true if found and false if unfound
+    bool deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) ;
+
+    // returns how many times a process has had to repair the heap
+    int repairs() ;
+
+    // prints out the contents of both heaps
+    void dump() ;
+
+private:
+    SharedMedianHeap(const SharedMedianHeap<T>& other);     // not copyable
+    const SharedMedianHeap<T>& operator=(const SharedMedianHeap<T>& rhs);
+
+    enum { LOWER = 0, UPPER = 1 };  // max heap and min heap
+
+    // start of the segment, every other address is an offset from here
+    struct Segment {
+        atomic<unsigned int> magic;     // SHARED_HEAP_MAGIC once ready
+        int itemBytes;      // sizeof(T) of the creator
+        int capacity;       // most items held
+        int heapCap;        // most items in one half
+        long long offset[2];    // of each half's array, 1 based
+        int heapSize[2];    // items in each half
+        int repairs;        // times a dead holder's lock was recovered
+        T min;
+        T max;
+        pthread_mutex_t lock;
+    };
+
+    // holds the segment's lock while in scope
+    struct Locked {
+        SharedMedianHeap<T> *heap;
+        Locked(SharedMedianHeap<T> *h) : heap(h) { heap->lock(); }
+        ~Locked() { heap->unlock(); }
+    };
+
+    static string shmName(const string& name) ;     // name with the leading / shm_open wants
+    static long long bytesFor(int heapCap) ;    // segment size
+    void create(int fd, int cap) ;  // sets up a new segment
+    void attach(int fd) ;   // maps a segment another process created
+    void lock() ;
+    void unlock() ;
+    void repair() ;     // restores both heaps after a holder died
+
+    T* items(int half) { return (T*)((char*)m_seg + m_seg->offset[half]); }
+    bool above(int half, const T& a, const T& b) { return half == LOWER ? greater(a, b) : less(a, b); }
+    void push(int half, const T& item) ;    // adds item to half
+    T pushPop(int half, const T& item) ;    // adds item to half and takes its root out
+    void removeAt(int half, int pos) ;      // deletes item at pos of half
+    void siftUp(int half, int pos) ;
+    void siftDown(int half, int pos) ;
+    void insertLocked(const T& item) ;  // insert with the lock held and room left
+    T medianLocked() ;
+    void findMin() ;
+    void findMax() ;
+
+    Segment *m_seg;     // this process's mapping
+    long long m_bytes;  // size of the mapping
+    int m_fd;
+    bool (*less) (const T&, const T&);
+    bool (*greater) (const T&, const T&);
+};
+
+// constructor for SharedMedianHeap class
+// the O_EXCL create decides which process sets the segment up
+template <typename T>
+SharedMedianHeap<T>::SharedMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&),
+                                       const string& name, int cap ) {
+    if (cap < 1){
+        throw out_of_range("Capacity must be at least one.");
+    }
+    less = lt;
+    greater = gt;
+    m_seg = NULL;
+    m_bytes = 0;
+    string path = shmName(name);
+    m_fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    bool created = m_fd >= 0;
+    if (!created){
+        if (errno != EEXIST){
+            throw runtime_error("Could not create shared memory " + path);
+        }
+        m_fd = shm_open(path.c_str(), O_RDWR, 0);
+        if (m_fd < 0){
+            throw runtime_error("Could not open shared memory " + path);
+        }
+    }
+    // the destructor won't run, so a failed set up cleans up here
+    try {
+        if (created){
+            create(m_fd, cap);
+        }
+        else {
+            attach(m_fd);
+        }
+    }
+    catch (...) {
+        if (m_seg != NULL){
+            munmap(m_seg, m_bytes);
+        }
+        close(m_fd);
+        if (created){
+            shm_unlink(path.c_str());
+        }
+        throw;
+    }
+}
+
+// SharedMedianHeap class destructor
+template <typename T>
+SharedMedianHeap<T>::~SharedMedianHeap() {
+    if (m_seg != NULL){
+        munmap(m_seg, m_bytes);
+        m_seg = NULL;
+    }
+    close(m_fd);
+}
+
+// removes name from the system
+template <typename T>
+bool SharedMedianHeap<T>::removeSegment(const string& name) {
+    return shm_unlink(shmName(name).c_str()) == 0;
+}
+
+// returns name starting with one /
+template <typename T>
+string SharedMedianHeap<T>::shmName(const string& name) {
+    return name.size() > 0 && name[0] == '/' ? name : "/" + name;
+}
+
+// header rounded up to a cache line, then each half's array likewise
+template <typename T>
+long long SharedMedianHeap<T>::bytesFor(int heapCap) {
+    long long header = ((long long)sizeof(Segment) + 63) / 64 * 64;
+    long long half = ((long long)(heapCap + 1) * sizeof(T) + 63) / 64 * 64;
+    return header + 2 * half;
+}
+
+// sizes and maps a new segment, sets up its robust mutex, and only then
+// sets magic so other processes know it is ready
+template <typename T>
+void SharedMedianHeap<T>::create(int fd, int cap) {
+    // either half can hold one more than the other
+    int heapCap = cap / 2 + 1;
+    m_bytes = bytesFor(heapCap);
+    if (ftruncate(fd, m_bytes) != 0){
+        throw runtime_error("Could not size shared memory.");
+    }
+    void *at = mmap(NULL, m_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (at == MAP_FAILED){
+        throw runtime_error("Could not map shared memory.");
+    }
+    m_seg = (Segment*)at;
+    m_seg->itemBytes = (int)sizeof(T);
+    m_seg->capacity = cap;
+    m_seg->heapCap = heapCap;
+    m_seg->offset[LOWER] = ((long long)sizeof(Segment) + 63) / 64 * 64;
+    m_seg->offset[UPPER] = m_seg->offset[LOWER] + ((long long)(heapCap + 1) * sizeof(T) + 63) / 64 * 64;
+    m_seg->heapSize[LOWER] = 0;
+    m_seg->heapSize[UPPER] = 0;
+    m_seg->repairs = 0;
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    int err = pthread_mutex_init(&m_seg->lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (err != 0){
+        throw runtime_error("Could not create shared mutex.");
+    }
+    m_seg->magic.store(SHARED_HEAP_MAGIC, memory_order_release);
+}
+
+// waits for the creator to size the segment and set magic, then maps
+// all of it
+template <typename T>
+void SharedMedianHeap<T>::attach(int fd) {
+    struct stat st;
+    int tries = 0;
+    while (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Segment)){
+        if (++tries > SHARED_OPEN_TRIES){
+            throw runtime_error("Shared memory was never set up.");
+        }
+        usleep(1000);
+    }
+    m_bytes = st.st_size;
+    void *at = mmap(NULL, m_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (at == MAP_FAILED){
+        throw runtime_error("Could not map shared memory.");
+    }
+    m_seg = (Segment*)at;
+    while (m_seg->magic.load(memory_order_acquire) != SHARED_HEAP_MAGIC){
+        if (++tries > SHARED_OPEN_TRIES){
+            throw runtime_error("Shared memory was never set up.");
+        }
+        usleep(1000);
+    }
+    if (m_seg->itemBytes != (int)sizeof(T) || bytesFor(m_seg->heapCap) > m_bytes){
+        throw runtime_error("Shared memory holds a different kind of heap.");
+    }
+}
+
+// locks the segment, repairing the heaps first if the last holder died
+template <typename T>
+void SharedMedianHeap<T>::lock() {
+    int err = pthread_mutex_lock(&m_seg->lock);
+    if (err == EOWNERDEAD){
+        repair();
+        m_seg->repairs++;
+        pthread_mutex_consistent(&m_seg->lock);
+    }
+    else if (err != 0){
+        throw runtime_error("Could not lock shared memory.");
+    }
+}
+
+template <typename T>
+void SharedMedianHeap<T>::unlock() {
+    pthread_mutex_unlock(&m_seg->lock);
+}
+
+// a dead holder may have left a half out of order or an item on the wrong
+// side, so every item is split again around the lower middle and each half
+// is heapified from its last parent up
+template <typename T>
+void SharedMedianHeap<T>::repair() {
+    vector<T> all;
+    for (int half = LOWER; half <= UPPER; half++){
+        int n = min(max(m_seg->heapSize[half], 0), m_seg->heapCap);
+        all.insert(all.end(), items(half) + 1, items(half) + 1 + n);
+    }
+    int n = (int)all.size();
+    int lowerSize = min((n + 1) / 2, m_seg->heapCap);
+    if (lowerSize > 0){
+        nth_element(all.begin(), all.begin() + lowerSize - 1, all.end(), less);
+    }
+    copy(all.begin(), all.begin() + lowerSize, items(LOWER) + 1);
+    copy(all.begin() + lowerSize, all.end(), items(UPPER) + 1);
+    m_seg->heapSize[LOWER] = lowerSize;
+    m_seg->heapSize[UPPER] = n - lowerSize;
+    for (int half = LOWER; half <= UPPER; half++){
+        for (int pos = m_seg->heapSize[half] / 2; pos >= 1; pos--){
+            siftDown(half, pos);
+        }
+    }
+    if (n > 0){
+        findMin();
+        findMax();
+    }
+}
+
+// returns the number of items
+template <typename T>
+int SharedMedianHeap<T>::size() {
+    Locked held(this);
+    return m_seg->heapSize[LOWER] + m_seg->heapSize[UPPER];
+}
+
+// returns the maximum number of items that can be stored
+template <typename T>
+int SharedMedianHeap<T>::capacity() {
+    return m_seg->capacity;
+}
+
+// returns how many times the heap has been repaired
+template <typename T>
+int SharedMedianHeap<T>::repairs() {
+    Locked held(this);
+    return m_seg->repairs;
+}
+
+// moves item at pos of half up until its parent belongs above it
+template <typename T>
+void SharedMedianHeap<T>::siftUp(int half, int pos) {
+    T *heap = items(half);
+    T item = heap[pos];
+    while (pos > 1 && above(half, item, heap[pos / 2])){
+        heap[pos] = heap[pos / 2];
+        pos = pos / 2;
+    }
+    heap[pos] = item;
+}
+
+// moves item at pos of half down until both children belong below it
+template <typename T>
+void SharedMedianHeap<T>::siftDown(int half, int pos) {
+    T *heap = items(half);
+    int size = m_seg->heapSize[half];
+    T item = heap[pos];
+    while (2 * pos <= size){
+        int c = 2 * pos;
+        if (c < size && above(half, heap[c + 1], heap[c])){
+            c++;
+        }
+        if (!above(half, heap[c], item)){
+            break;
+        }
+        heap[pos] = heap[c];
+        pos = c;
+    }
+    heap[pos] = item;
+}
+
+// adds item as the last position of half and bubbles it up
+template <typename T>
+void SharedMedianHeap<T>::push(int half, const T& item) {
+    int pos = m_seg->heapSize[half] + 1;
+    items(half)[pos] = item;
+    // the compiler mustn't count the slot before it is filled
+    atomic_signal_fence(memory_order_seq_cst);
+    m_seg->heapSize[half] = pos;
+    siftUp(half, pos);
+}
+
+// same as push followed by taking the root out, but with one sift, and none
+// if item would be the root
+template <typename T>
+T SharedMedianHeap<T>::pushPop(int half, const T& item) {
+    T *heap = items(half);
+    if (m_seg->heapSize[half] == 0 || !above(half, heap[1], item)){
+        return item;
+    }
+    T top = heap[1];
+    heap[1] = item;
+    siftDown(half, 1);
+    return top;
+}
+
+// fills pos with the last item of half, which then moves whichever way it must
+template <typename T>
+void SharedMedianHeap<T>::removeAt(int half, int pos) {
+    T *heap = items(half);
+    int last = m_seg->heapSize[half];
+    heap[pos] = heap[last];
+    // the last item is doubled until the size drops, never lost
+    atomic_signal_fence(memory_order_seq_cst);
+    m_seg->heapSize[half] = last - 1;
+    if (pos == last){
+        return;
+    }
+    siftUp(half, pos);
+    siftDown(half, pos);
+}
+
+// returns the median, the root of the larger half or of the max heap if even
+template <typename T>
+T SharedMedianHeap<T>::medianLocked() {
+    if (m_seg->heapSize[UPPER] > m_seg->heapSize[LOWER]){
+        return items(UPPER)[1];
+    }
+    return items(LOWER)[1];
+}
+
+// adds item to the half it belongs in, as MedianHeap::insert does. If that
+// half already has the extra item, its root is popped across instead
+template <typename T>
+void SharedMedianHeap<T>::insertLocked(const T& item) {
+    if (m_seg->heapSize[LOWER] + m_seg->heapSize[UPPER] == 0){
+        push(UPPER, item);
+        m_seg->min = item;
+        m_seg->max = item;
+        return;
+    }
+    if (less(item, medianLocked())){
+        if (m_seg->heapSize[LOWER] > m_seg->heapSize[UPPER]){
+            push(UPPER, pushPop(LOWER, item));
+        }
+        else {
+            push(LOWER, item);
+        }
+        if (less(item, m_seg->min)) {m_seg->min = item;}
+    }
+    else {
+        if (m_seg->heapSize[UPPER] > m_seg->heapSize[LOWER]){
+            push(LOWER, pushPop(UPPER, item));
+        }
+        else {
+            push(UPPER, item);
+        }
+        if (greater(item, m_seg->max)) {m_seg->max = item;}
+    }
+}
+
+// adds item, throws if full
+template <typename T>
+void SharedMedianHeap<T>::insert(const T& item) {
+    Locked held(this);
+    if (m_seg->heapSize[LOWER] + m_seg->heapSize[UPPER] >= m_seg->capacity){
+        throw out_of_range("The SharedMedianHeap is full. Cannot insert item.");
+    }
+    insertLocked(item);
+}
+
+// adds items from batch until count are in or the heap is full
+template <typename T>
+int SharedMedianHeap<T>::insertMany(const T* batch, int count) {
+    Locked held(this);
+    int room = m_seg->capacity - m_seg->heapSize[LOWER] - m_seg->heapSize[UPPER];
+    int added = max(min(count, room), 0);
+    for (int i=0; i < added; i++){
+        insertLocked(batch[i]);
+    }
+    return added;
+}
+
+// returns a copy of the median
+template <typename T>
+T SharedMedianHeap<T>::getMedian() {
+    Locked held(this);
+    if (m_seg->heapSize[LOWER] + m_seg->heapSize[UPPER] == 0){
+        throw out_of_range("The SharedMedianHeap is empty.");
+    }
+    return medianLocked();
+}
+
+// returns a copy of the min
+template <typename T>
+T SharedMedianHeap<T>::getMin() {
+    Locked held(this);
+    if (m_seg->heapSize[LOWER] + m_seg->heapSize[UPPER] == 0){
+        throw out_of_range("The SharedMedianHeap is empty.");
+    }
+    return m_seg->min;
+}
+
+// returns a copy of the max
+template <typename T>
+T SharedMedianHeap<T>::getMax() {
+    Locked held(this);
+    if (m_seg->heapSize[LOWER] + m_seg->heapSize[UPPER] == 0){
+        throw out_of_range("The SharedMedianHeap is empty.");
+    }
+    return m_seg->max;
+}
+
+// finds new min, a leaf of the max heap or the min heap's root if it's empty
+template <typename T>
+void SharedMedianHeap<T>::findMin() {
+    if (m_seg->heapSize[LOWER] == 0){
+        m_seg->min = items(UPPER)[1];
+        return;
+    }
+    T *heap = items(LOWER);
+    T temp = heap[1];
+    for (int i = m_seg->heapSize[LOWER] / 2 + 1; i <= m_seg->heapSize[LOWER]; i++){
+        if (less(heap[i], temp)){
+            temp = heap[i];
+        }
+    }
+    m_seg->min = temp;
+}
+
+// finds new max, a leaf of the min heap or the max heap's root if it's empty
+template <typename T>
+void SharedMedianHeap<T>::findMax() {
+    if (m_seg->heapSize[UPPER] == 0){
+        m_seg->max = items(LOWER)[1];
+        return;
+    }
+    T *heap = items(UPPER);
+    T temp = heap[1];
+    for (int i = m_seg->heapSize[UPPER] / 2 + 1; i <= m_seg->heapSize[UPPER]; i++){
+        if (greater(heap[i], temp)){
+            temp = heap[i];
+        }
+    }
+    m_seg->max = temp;
+}
+
+// looks for givenItem in the max heap then the min heap, copies the match
+// into givenItem, deletes it and moves a root across if the halves are off
+// by two
+template <typename T>
+bool SharedMedianHeap<T>::deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) {
+    Locked held(this);
+    if (m_seg->heapSize[LOWER] + m_seg->heapSize[UPPER] == 0){
+        throw out_of_range("The heap is empty, cannot remove item.");
+    }
+    for (int half = LOWER; half <= UPPER; half++){
+        T *heap = items(half);
+        for (int i=1; i <= m_seg->heapSize[half]; i++){
+            if (!equalTo(heap[i], givenItem)){
+                continue;
+            }
+            givenItem = heap[i];
+            removeAt(half, i);
+            int other = 1 - half;
+            if (m_seg->heapSize[other] > m_seg->heapSize[half] + 1){
+                T root = items(other)[1];
+                removeAt(other, 1);
+                push(half, root);
+            }
+            if (m_seg->heapSize[LOWER] + m_seg->heapSize[UPPER] > 0){
+                if (equalTo(givenItem, m_seg->min)){
+                    findMin();
+                }
+                else if (equalTo(givenItem, m_seg->max)){
+                    findMax();
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// prints out the contents of both heaps and the min, median and max
+template <typename T>
+void SharedMedianHeap<T>::dump() {
+    Locked held(this);
+    cout << "... SharedMedianHeap()::dump() ..." << endl;
+    cout << endl;
+    cout << "------------Max Heap------------" << endl;
+    cout << "size = " << m_seg->heapSize[LOWER] << ", ";
+    cout << "capacity = " << m_seg->heapCap << endl;
+    for (int i=1; i <= m_seg->heapSize[LOWER]; i++){
+        cout << "Heap[" << i << "] = (" << items(LOWER)[i] << ")" << endl;
+    }
+    cout << endl;
+    cout << "------------Min Heap------------" << endl;
+    cout << "size = " << m_seg->heapSize[UPPER] << ", ";
+    cout << "capacity = " << m_seg->heapCap << endl;
+    for (int i=1; i <= m_seg->heapSize[UPPER]; i++){
+        cout << "Heap[" << i << "] = (" << items(UPPER)[i] << ")" << endl;
+    }
+    cout << "--------------------------------" << endl;
+    if (m_seg->heapSize[LOWER] + m_seg->heapSize[UPPER] > 0){
+        cout << "min    = " << m_seg->min << endl;
+        cout << "median = " << medianLocked() << endl;
+        cout << "max    = " << m_seg->max << endl;
+    }
+}
+
+#endif
@@ -0,0 +1,533 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    SnapshotMedianHeap.h
+*/
+
+#ifndef _SNAPSHOTMEDIANHEAP_H_
+#define _SNAPSHOTMEDIANHEAP_H_
+
+#include <iostream>
+#include <stdexcept>
+#include <atomic>
+using namespace std;
+
+const int COW_SHIFT = 8;    // log2 of items per chunk
+const int COW_CHUNK = 1 << COW_SHIFT;   // items per chunk
+const int COW_MASK = COW_CHUNK - 1;
+
+// CowHeap is a Heap whose array is split into fixed size chunks that are
+// shared between copies. Copying a CowHeap only bumps the count on its chunk
+// table. The first write after a copy copies the table, and each write copies
+// the chunk it lands in if another heap still shares it.
+template <typename T>
+class CowHeap {
+public:
+    CowHeap(int cap, bool (*cmp) (const T&, const T&)); // constructor
+    CowHeap(const CowHeap<T>& other);   // copy constructor, shares storage
+    ~CowHeap(); // destructor
+    const CowHeap<T>& operator=(const CowHeap<T>& rhs);   // overloaded assignment operator
+
+    void insert(const T& item); // inserts passed in item at end of heap
+    void bubbleUp(int pos);     // moves item up heap if not in correct position
+    void deleteH(int pos);      // deletes item at specified position
+    void trickleDown(int pos);  // moves item down heap if not in correct position
+
+    // returns item at pos, reading never copies anything
+    const T& get(int pos) const { return m_table->chunks[pos >> COW_SHIFT]->items[pos & COW_MASK]; }
+    void set(int pos, const T& item);   // writes item at pos, copying shared storage first
+
+    int m_heapSize; // number of items in heap
+    int m_heapCap;  // max capacity of heap
+    bool (*compare)(const T&, const T&);    // comparison operator
+
+private:
+    struct Chunk {
+        atomic<int> refs;   // number of tables pointing at chunk
+        T items[COW_CHUNK];
+    };
+    struct Table {
+        atomic<int> refs;   // number of heaps pointing at table
+        int numChunks;
+        Chunk **chunks;     // chunk i holds positions i*COW_CHUNK on
+    };
+
+    void release();     // drops this heap's reference to its table
+    Table *m_table;
+};
+
+// SnapshotMedianHeap is a MedianHeap built on CowHeap so snapshot(), the copy
+// constructor and assignment take O(1) time no matter how many items it holds.
+// Afterwards the live heap and snapshot each copy only the chunks they write.
+// Taking a snapshot must not race with a write to the same object, but the
+// snapshot can then be read or destroyed on another thread while the live
+// heap keeps changing.
+template <typename T>
+class SnapshotMedianHeap {
+public:
+    // constructor for SnapshotMedianHeap class
+    // must create a SnapshotMedianHeap object capable of holding cap items
+    SnapshotMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap=100 ) ;
+
+    // returns a copy of this SnapshotMedianHeap that shares its storage
+    SnapshotMedianHeap<T> snapshot() ;
+
+    // returns the total number of items in the SnapshotMedianHeap
+    int size() ;
+
+    // returns the maximum number of items that can be stored in the SnapshotMedianHeap
+    int capacity() ;
+
+    // adds the item given in the parameter to the SnapshotMedianHeap
+    void insert(const T& item) ;
+
+    // returns a copy of the median key object
+    T getMedian() ;
+
+    // returns a copy of the minimum key object
+    T getMin() ;
+
+    // returns a copy of the maximum key object
+    T getMax() ;
+
+    // deletes specified item from SnapshotMedianHeap, returns true if found and false if unfound
+    bool deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) ;
+
+    // prints out the contents of the SnapshotMedianHeap
+    void dump() ;
+
+    // returns the number of items in the max heap
+    int maxHeapSize() ;
+
+    // returns the number of items in the min heap
+    int minHeapSize() ;
+
+    T locateInMaxHeap(int pos) ;
+
+    T locateInMinHeap(int pos) ;
+
+private:
+    void findMin(); // finds new min
+    void findMax(); // finds new max
+    void balance(); // moves a root across if heaps differ by more than one
+
+    CowHeap<T> minHeap;    // min heap object
+    CowHeap<T> maxHeap;    // max heap object
+
+    T m_min;    // min object in SnapshotMedianHeap
+    T m_max;    // max object in SnapshotMedianHeap
+    int m_capacity; // capacity of heap
+    bool (*less) (const T&, const T&);
+    bool (*greater) (const T&, const T&);
+};
+
+//**************************** CowHeap Class *******************************
+
+// CowHeap class constructor
+// creates an unshared table, chunks are allocated the first time they are written
+template <typename T>
+CowHeap<T>::CowHeap(int cap, bool (*cmp) (const T&, const T&)) {
+    m_heapCap = cap;
+    m_heapSize = 0;
+    compare = cmp;
+
+    m_table = new Table;
+    m_table->refs = 1;
+    m_table->numChunks = (cap >> COW_SHIFT) + 1;
+    m_table->chunks = new Chunk*[m_table->numChunks];
+    for (int i=0; i < m_table->numChunks; i++){
+        m_table->chunks[i] = NULL;
+    }
+}
+
+// CowHeap class copy constructor
+// shares other's table instead of copying items
+template <typename T>
+CowHeap<T>::CowHeap(const CowHeap<T>& other) {
+    m_heapCap = other.m_heapCap;
+    m_heapSize = other.m_heapSize;
+    compare = other.compare;
+    m_table = other.m_table;
+    m_table->refs++;
+}
+
+// CowHeap class destructor
+template <typename T>
+CowHeap<T>::~CowHeap() {
+    release();
+    m_table = NULL;
+    m_heapCap = 0;
+    m_heapSize = 0;
+}
+
+// CowHeap class overloaded assignment operator
+// drops the host's table and shares rhs's
+template <typename T>
+const CowHeap<T>& CowHeap<T>::operator=(const CowHeap<T>& rhs) {
+    // checks first for self-assignment, if true returns object
+    if(this == &rhs){
+        return *this;
+    }
+    rhs.m_table->refs++;
+    release();
+
+    m_heapCap = rhs.m_heapCap;
+    m_heapSize = rhs.m_heapSize;
+    compare = rhs.compare;
+    m_table = rhs.m_table;
+
+    return *this;
+}
+
+// if this was the last heap using the table, frees the table and
+// every chunk no other table is using
+template <typename T>
+void CowHeap<T>::release() {
+    if (--m_table->refs > 0){
+        return;
+    }
+    for (int i=0; i < m_table->numChunks; i++){
+        Chunk *c = m_table->chunks[i];
+        if (c != NULL && --c->refs == 0){
+            delete c;
+        }
+    }
+    delete[] m_table->chunks;
+    delete m_table;
+}
+
+// writes item at pos, first making the table and then the chunk
+// private to this heap if they are shared
+template <typename T>
+void CowHeap<T>::set(int pos, const T& item) {
+    if (m_table->refs.load() > 1){
+        // copy table, new table points at the same chunks
+        Table *t = new Table;
+        t->refs = 1;
+        t->numChunks = m_table->numChunks;
+        t->chunks = new Chunk*[t->numChunks];
+        for (int i=0; i < t->numChunks; i++){
+            t->chunks[i] = m_table->chunks[i];
+            if (t->chunks[i] != NULL){
+                t->chunks[i]->refs++;
+            }
+        }
+        release();
+        m_table = t;
+    }
+
+    Chunk *&c = m_table->chunks[pos >> COW_SHIFT];
+    if (c == NULL){
+        c = new Chunk;
+        c->refs = 1;
+    }
+    else if (c->refs.load() > 1){
+        // copy chunk, item may point into the old chunk so write it first
+        Chunk *old = c;
+        Chunk *copy = new Chunk;
+        copy->refs = 1;
+        for (int i=0; i < COW_CHUNK; i++){
+            copy->items[i] = old->items[i];
+        }
+        copy->items[pos & COW_MASK] = item;
+        c = copy;
+        // another heap may have dropped the old chunk since refs was read
+        if (--old->refs == 0){
+            delete old;
+        }
+        return;
+    }
+    c->items[pos & COW_MASK] = item;
+}
+
+// inserts passed item at the last position in the heap and bubbles up
+template <typename T>
+void CowHeap<T>::insert(const T& item) {
+    // if heap is full throw error
+    if(m_heapSize == m_heapCap){
+        throw out_of_range("Could not insert item. Heap is full.");
+    }
+    m_heapSize++;
+    set(m_heapSize, item);
+    bubbleUp(m_heapSize);
+}
+
+// moves item at pos up while it comes before its parent
+template <typename T>
+void CowHeap<T>::bubbleUp(int pos) {
+    T item = get(pos);
+    while(pos > 1 && compare(item, get(pos/2))){
+        set(pos, get(pos/2));
+        pos = pos/2;
+    }
+    set(pos, item);
+}
+
+// removes item from heap at the specified position
+template <typename T>
+void CowHeap<T>::deleteH(int pos) {
+    // last item in heap fills the hole
+    T last = get(m_heapSize);
+    m_heapSize--;
+    if(pos > m_heapSize){
+        return;
+    }
+    set(pos, last);
+    // if violates heap condition with parent, bubbleUp, else trickleDown
+    if(pos > 1 && compare(get(pos), get(pos/2))){
+        bubbleUp(pos);
+    }
+    else {
+        trickleDown(pos);
+    }
+}
+
+// moves item at pos down while a child comes before it
+template <typename T>
+void CowHeap<T>::trickleDown(int pos) {
+    T item = get(pos);
+    while(2*pos <= m_heapSize){
+        int x = 2*pos;
+        // use right child if it comes before left
+        if(x + 1 <= m_heapSize && compare(get(x+1), get(x))){
+            x++;
+        }
+        if(!compare(get(x), item)){
+            break;
+        }
+        set(pos, get(x));
+        pos = x;
+    }
+    set(pos, item);
+}
+
+//********************** SnapshotMedianHeap Class **************************
+
+// constructor for SnapshotMedianHeap class
+// heaps are sized the same as in MedianHeap
+template <typename T>
+SnapshotMedianHeap<T>::SnapshotMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap)
+    : minHeap((cap/2) + 2, lt), maxHeap((cap/2) + 2, gt) {
+    m_capacity = cap;
+    less = lt;
+    greater = gt;
+}
+
+// returns a copy that shares both heaps' storage, O(1)
+template <typename T>
+SnapshotMedianHeap<T> SnapshotMedianHeap<T>::snapshot() {
+    return *this;
+}
+
+// returns the total number of items in the SnapshotMedianHeap
+template <typename T>
+int SnapshotMedianHeap<T>::size() {
+    return (minHeap.m_heapSize + maxHeap.m_heapSize);
+}
+
+// returns the maximum number of items that can be stored in the SnapshotMedianHeap
+template <typename T>
+int SnapshotMedianHeap<T>::capacity() {
+    return m_capacity;
+}
+
+// adds item to the max heap if less than the median, else to the min heap
+template <typename T>
+void SnapshotMedianHeap<T>::insert(const T& item) {
+    // if SnapshotMedianHeap is full throw out of range error
+    if(size() == capacity()){
+        throw out_of_range("The SnapshotMedianHeap is full. Cannot insert item.");
+    }
+    // if SnapshotMedianHeap is empty, item is min, max and median
+    if(size() == 0){
+        minHeap.insert(item);
+        m_min = item;
+        m_max = item;
+        return;
+    }
+    if(less(item, getMedian())){
+        maxHeap.insert(item);
+    }
+    else {
+        minHeap.insert(item);
+    }
+    // check if min or max needs to be changed
+    if(less(item, m_min)) {m_min = item;}
+    if(greater(item, m_max)) {m_max = item;}
+    balance();
+}
+
+// returns a copy of the median key object
+template <typename T>
+T SnapshotMedianHeap<T>::getMedian() {
+    if(size() == 0){
+        throw out_of_range("The SnapshotMedianHeap is empty.");
+    }
+    if (minHeap.m_heapSize > maxHeap.m_heapSize){
+        return minHeap.get(1);
+    }
+    return maxHeap.get(1);
+}
+
+// returns a copy of the min key object
+template <typename T>
+T SnapshotMedianHeap<T>::getMin() {
+    return m_min;
+}
+
+// returns a copy of the max key object
+template <typename T>
+T SnapshotMedianHeap<T>::getMax() {
+    return m_max;
+}
+
+// looks for givenItem in SnapshotMedianHeap and if found deletes item and returns true
+// if unfound, SnapshotMedianHeap is unchanged and returns false
+template <typename T>
+bool SnapshotMedianHeap<T>::deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) {
+    // if the SnapshotMedianHeap is empty throw out of range error
+    if(size() == 0) {
+        throw out_of_range("The heap is empty, cannot remove item.");
+    }
+    bool found = false;
+    for (int i=1; !found && i <= maxHeap.m_heapSize; i++){
+        if (equalTo(maxHeap.get(i), givenItem)){
+            givenItem = maxHeap.get(i);
+            maxHeap.deleteH(i);
+            found = true;
+        }
+    }
+    for (int i=1; !found && i <= minHeap.m_heapSize; i++){
+        if (equalTo(minHeap.get(i), givenItem)){
+            givenItem = minHeap.get(i);
+            minHeap.deleteH(i);
+            found = true;
+        }
+    }
+    if (!found){
+        return false;
+    }
+    balance();
+
+    // if deleted item was min or max find the new one
+    if (size() > 0 && equalTo(givenItem, m_min)){
+        findMin();
+    }
+    else if (size() > 0 && equalTo(givenItem, m_max)){
+        findMax();
+    }
+    return true;
+}
+
+// called when min is deleted, smallest item is a leaf of the max heap
+// or the min heap root if the max heap is empty
+template <typename T>
+void SnapshotMedianHeap<T>::findMin() {
+    if (maxHeap.m_heapSize == 0){
+        m_min = minHeap.get(1);
+        return;
+    }
+    T temp = maxHeap.get(1);
+    for(int i = maxHeap.m_heapSize/2 + 1; i <= maxHeap.m_heapSize; i++){
+        if(less(maxHeap.get(i), temp)){
+            temp = maxHeap.get(i);
+        }
+    }
+    m_min = temp;
+}
+
+// called when max is deleted, largest item is a leaf of the min heap
+// or the max heap root if the min heap is empty
+template <typename T>
+void SnapshotMedianHeap<T>::findMax() {
+    if (minHeap.m_heapSize == 0){
+        m_max = maxHeap.get(1);
+        return;
+    }
+    T temp = minHeap.get(1);
+    for(int i = minHeap.m_heapSize/2 + 1; i <= minHeap.m_heapSize; i++){
+        if(greater(minHeap.get(i), temp)){
+            temp = minHeap.get(i);
+        }
+    }
+    m_max = temp;
+}
+
+// moves the root of the bigger heap into the other if they differ by more than one
+template <typename T>
+void SnapshotMedianHeap<T>::balance() {
+    if(maxHeap.m_heapSize > minHeap.m_heapSize + 1) {
+        minHeap.insert(maxHeap.get(1));
+        maxHeap.deleteH(1);
+    }
+    else if (minHeap.m_heapSize > maxHeap.m_heapSize + 1) {
+        maxHeap.insert(minHeap.get(1));
+        minHeap.deleteH(1);
+    }
+}
+
+// prints out max and min heap data in proper format
+template <typename T>
+void SnapshotMedianHeap<T>::dump() {
+    cout << "... SnapshotMedianHeap()::dump() ..." << endl;
+    cout << endl;
+    // prints max heap data
+    cout << "------------Max Heap------------" << endl;
+    cout << "size = " << maxHeap.m_heapSize << ", ";
+    cout << "capacity = " << maxHeap.m_heapCap - 1 << endl;
+    for (int i=1; i <= maxHeap.m_heapSize; i++){
+        cout << "Heap[" << i << "] = (" << maxHeap.get(i) << ")"<< endl;
+    }
+    cout << endl;
+
+    // prints min heap data
+    cout << "------------Min Heap------------" << endl;
+    cout << "size = " << minHeap.m_heapSize << ", ";
+    cout << "capacity = " << minHeap.m_heapCap - 1 << endl;
+    for (int i=1; i <= minHeap.m_heapSize; i++){
+        cout << "Heap[" << i << "] = (" << minHeap.get(i) << ")" << endl;
+    }
+
+    cout << "--------------------------------" << endl;
+    if (size() > 0){
+        cout << "min    = " << m_min << endl;
+        cout << "median = " << getMedian() << endl;
+        cout << "max    = " << m_max << endl;
+    }
+}
+
+// returns the number of items in the max heap
+template <typename T>
+int SnapshotMedianHeap<T>::maxHeapSize() {
+    return maxHeap.m_heapSize;
+}
+
+// returns the number of items in the min heap
+template <typename T>
+int SnapshotMedianHeap<T>::minHeapSize() {
+    return minHeap.m_heapSize;
+}
+
+// returns a copy of the item in position pos in the max heap
+template <typename T>
+T SnapshotMedianHeap<T>::locateInMaxHeap(int pos) {
+    // if pos is invalid, throw error
+    if(pos < 1 || pos > maxHeapSize()){
+        throw out_of_range("Position specified is invalid or out of range.");
+    }
+    return maxHeap.get(pos);
+}
+
+// returns a copy of the item in position pos in the min heap
+template <typename T>
+T SnapshotMedianHeap<T>::locateInMinHeap(int pos) {
+    // if pos is invalid, throw error
+    if(pos < 1 || pos > minHeapSize()){
+        throw out_of_range("Position specified is invalid or out of range.");
+    }
+    return minHeap.get(pos);
+}
+
+#endif
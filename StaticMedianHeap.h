@@ -0,0 +1,383 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    StaticMedianHeap.h
+*/
+
+#ifndef _STATICMEDIANHEAP_H_
+#define _STATICMEDIANHEAP_H_
+
+#include <iostream>
+#include <stdexcept>
+#include <array>
+using namespace std;
+
+// StaticHeap is a Heap with its array stored inline, capacity CAP is fixed
+// at compile time. The comparison is passed in by the owner on each call so
+// the heap holds nothing but items and a size.
+template <typename T, int CAP>
+struct StaticHeap {
+    void insert(const T& item, bool (*compare)(const T&, const T&)); // inserts item at end and bubbles up
+    void deleteH(int pos, bool (*compare)(const T&, const T&));  // deletes item at specified position
+    void bubbleUp(int pos, bool (*compare)(const T&, const T&));    // moves item up heap
+    void trickleDown(int pos, bool (*compare)(const T&, const T&)); // moves item down heap
+
+    array<T, CAP + 1> m_heap;   // array that holds heap objects, 1 based
+    int m_heapSize;     // number of items in heap
+};
+
+// StaticMedianHeap is a MedianHeap holding at most N items with no dynamic
+// allocation. Both heaps live inside the object, so it is trivially copyable
+// whenever T is and can be placed in a per-connection struct or shared memory.
+// If no comparison functions are given, < and > on T are used; this keeps the
+// object free of function pointers, which are not valid across processes.
+template <typename T, int N>
+class StaticMedianHeap {
+public:
+    // each heap holds at most half the items, plus one before balance()
+    static constexpr int HEAP_CAP = N/2 + 1;
+
+    // constructor for StaticMedianHeap class
+    StaticMedianHeap( bool (*lt) (const T&, const T&) = NULL, bool (*gt) (const T&, const T&) = NULL ) ;
+
+    // returns the total number of items in the StaticMedianHeap
+    int size() ;
+
+    // returns the maximum number of items that can be stored, N
+    int capacity() ;
+
+    // adds the item given in the parameter to the StaticMedianHeap
+    void insert(const T& item) ;
+
+    // returns a copy of the median key object
+    T getMedian() ;
+
+    // returns a copy of the minimum key object
+    T getMin() ;
+
+    // returns a copy of the maximum key object
+    T getMax() ;
+
+    // deletes specified item from StaticMedianHeap, returns true if found and false if unfound
+    bool deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) ;
+
+    // prints out the contents of the StaticMedianHeap
+    void dump() ;
+
+    // returns the number of items in the max heap
+    int maxHeapSize() ;
+
+    // returns the number of items in the min heap
+    int minHeapSize() ;
+
+    T locateInMaxHeap(int pos) ;
+
+    T locateInMinHeap(int pos) ;
+
+private:
+    static bool defaultLess(const T& a, const T& b) { return a < b; }
+    static bool defaultGreater(const T& a, const T& b) { return a > b; }
+
+    // returns the comparison functions, falling back on < and >
+    bool (*lessFn())(const T&, const T&) { return less ? less : defaultLess; }
+    bool (*greaterFn())(const T&, const T&) { return greater ? greater : defaultGreater; }
+
+    void findMin(); // finds new min
+    void findMax(); // finds new max
+    void balance(); // moves a root across if heaps differ by more than one
+
+    StaticHeap<T, HEAP_CAP> minHeap;    // min heap object
+    StaticHeap<T, HEAP_CAP> maxHeap;    // max heap object
+
+    T m_min;    // min object in StaticMedianHeap
+    T m_max;    // max object in StaticMedianHeap
+    bool (*less) (const T&, const T&);
+    bool (*greater) (const T&, const T&);
+};
+
+//************************** StaticHeap Struct *****************************
+
+// inserts item at the last position in the heap and bubbles it up
+template <typename T, int CAP>
+void StaticHeap<T, CAP>::insert(const T& item, bool (*compare)(const T&, const T&)) {
+    // if heap is full throw error
+    if(m_heapSize == CAP){
+        throw out_of_range("Could not insert item. Heap is full.");
+    }
+    m_heapSize++;
+    m_heap[m_heapSize] = item;
+    bubbleUp(m_heapSize, compare);
+}
+
+// removes item from heap at the specified position
+template <typename T, int CAP>
+void StaticHeap<T, CAP>::deleteH(int pos, bool (*compare)(const T&, const T&)) {
+    // last item in heap fills the hole
+    m_heap[pos] = m_heap[m_heapSize];
+    m_heapSize--;
+    if(pos > m_heapSize){
+        return;
+    }
+    // if violates heap condition with parent, bubbleUp, else trickleDown
+    if(pos > 1 && compare(m_heap[pos], m_heap[pos/2])){
+        bubbleUp(pos, compare);
+    }
+    else {
+        trickleDown(pos, compare);
+    }
+}
+
+// moves item at pos up while it comes before its parent
+template <typename T, int CAP>
+void StaticHeap<T, CAP>::bubbleUp(int pos, bool (*compare)(const T&, const T&)) {
+    T item = m_heap[pos];
+    while(pos > 1 && compare(item, m_heap[pos/2])){
+        m_heap[pos] = m_heap[pos/2];
+        pos = pos/2;
+    }
+    m_heap[pos] = item;
+}
+
+// moves item at pos down while a child comes before it
+template <typename T, int CAP>
+void StaticHeap<T, CAP>::trickleDown(int pos, bool (*compare)(const T&, const T&)) {
+    T item = m_heap[pos];
+    while(2*pos <= m_heapSize){
+        int x = 2*pos;
+        // use right child if it comes before left
+        if(x + 1 <= m_heapSize && compare(m_heap[x+1], m_heap[x])){
+            x++;
+        }
+        if(!compare(m_heap[x], item)){
+            break;
+        }
+        m_heap[pos] = m_heap[x];
+        pos = x;
+    }
+    m_heap[pos] = item;
+}
+
+//********************** StaticMedianHeap Class ****************************
+
+// constructor for StaticMedianHeap class
+// storage is inline so only the sizes and comparisons need setting
+template <typename T, int N>
+StaticMedianHeap<T, N>::StaticMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&) ) {
+    minHeap.m_heapSize = 0;
+    maxHeap.m_heapSize = 0;
+    less = lt;
+    greater = gt;
+}
+
+// returns the total number of items in the StaticMedianHeap
+template <typename T, int N>
+int StaticMedianHeap<T, N>::size() {
+    return (minHeap.m_heapSize + maxHeap.m_heapSize);
+}
+
+// returns the maximum number of items that can be stored in the StaticMedianHeap
+template <typename T, int N>
+int StaticMedianHeap<T, N>::capacity() {
+    return N;
+}
+
+// adds item to the max heap if less than the median, else to the min heap
+template <typename T, int N>
+void StaticMedianHeap<T, N>::insert(const T& item) {
+    // if StaticMedianHeap is full throw out of range error
+    if(size() == N){
+        throw out_of_range("The StaticMedianHeap is full. Cannot insert item.");
+    }
+    // if StaticMedianHeap is empty, item is min, max and median
+    if(size() == 0){
+        minHeap.insert(item, lessFn());
+        m_min = item;
+        m_max = item;
+        return;
+    }
+    if(lessFn()(item, getMedian())){
+        maxHeap.insert(item, greaterFn());
+    }
+    else {
+        minHeap.insert(item, lessFn());
+    }
+    // check if min or max needs to be changed
+    if(lessFn()(item, m_min)) {m_min = item;}
+    if(greaterFn()(item, m_max)) {m_max = item;}
+    balance();
+}
+
+// returns a copy of the median key object
+template <typename T, int N>
+T StaticMedianHeap<T, N>::getMedian() {
+    if(size() == 0){
+        throw out_of_range("The StaticMedianHeap is empty.");
+    }
+    if (minHeap.m_heapSize > maxHeap.m_heapSize){
+        return minHeap.m_heap[1];
+    }
+    return maxHeap.m_heap[1];
+}
+
+// returns a copy of the min key object
+template <typename T, int N>
+T StaticMedianHeap<T, N>::getMin() {
+    return m_min;
+}
+
+// returns a copy of the max key object
+template <typename T, int N>
+T StaticMedianHeap<T, N>::getMax() {
+    return m_max;
+}
+
+// looks for givenItem in StaticMedianHeap and if found deletes item and returns true
+// if unfound, StaticMedianHeap is unchanged and returns false
+template <typename T, int N>
+bool StaticMedianHeap<T, N>::deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) {
+    // if the StaticMedianHeap is empty throw out of range error
+    if(size() == 0) {
+        throw out_of_range("The heap is empty, cannot remove item.");
+    }
+    bool found = false;
+    for (int i=1; !found && i <= maxHeap.m_heapSize; i++){
+        if (equalTo(maxHeap.m_heap[i], givenItem)){
+            givenItem = maxHeap.m_heap[i];
+            maxHeap.deleteH(i, greaterFn());
+            found = true;
+        }
+    }
+    for (int i=1; !found && i <= minHeap.m_heapSize; i++){
+        if (equalTo(minHeap.m_heap[i], givenItem)){
+            givenItem = minHeap.m_heap[i];
+            minHeap.deleteH(i, lessFn());
+            found = true;
+        }
+    }
+    if (!found){
+        return false;
+    }
+    balance();
+
+    // if deleted item was min or max find the new one
+    if (size() > 0 && equalTo(givenItem, m_min)){
+        findMin();
+    }
+    else if (size() > 0 && equalTo(givenItem, m_max)){
+        findMax();
+    }
+    return true;
+}
+
+// called when min is deleted, smallest item is a leaf of the max heap
+// or the min heap root if the max heap is empty
+template <typename T, int N>
+void StaticMedianHeap<T, N>::findMin() {
+    if (maxHeap.m_heapSize == 0){
+        m_min = minHeap.m_heap[1];
+        return;
+    }
+    T temp = maxHeap.m_heap[1];
+    for(int i = maxHeap.m_heapSize/2 + 1; i <= maxHeap.m_heapSize; i++){
+        if(lessFn()(maxHeap.m_heap[i], temp)){
+            temp = maxHeap.m_heap[i];
+        }
+    }
+    m_min = temp;
+}
+
+// called when max is deleted, largest item is a leaf of the min heap
+// or the max heap root if the min heap is empty
+template <typename T, int N>
+void StaticMedianHeap<T, N>::findMax() {
+    if (minHeap.m_heapSize == 0){
+        m_max = maxHeap.m_heap[1];
+        return;
+    }
+    T temp = minHeap.m_heap[1];
+    for(int i = minHeap.m_heapSize/2 + 1; i <= minHeap.m_heapSize; i++){
+        if(greaterFn()(minHeap.m_heap[i], temp)){
+            temp = minHeap.m_heap[i];
+        }
+    }
+    m_max = temp;
+}
+
+// moves the root of the bigger heap into the other if they differ by more than one
+template <typename T, int N>
+void StaticMedianHeap<T, N>::balance() {
+    if(maxHeap.m_heapSize > minHeap.m_heapSize + 1) {
+        minHeap.insert(maxHeap.m_heap[1], lessFn());
+        maxHeap.deleteH(1, greaterFn());
+    }
+    else if (minHeap.m_heapSize > maxHeap.m_heapSize + 1) {
+        maxHeap.insert(minHeap.m_heap[1], greaterFn());
+        minHeap.deleteH(1, lessFn());
+    }
+}
+
+// prints out max and min heap data in proper format
+template <typename T, int N>
+void StaticMedianHeap<T, N>::dump() {
+    cout << "... StaticMedianHeap()::dump() ..." << endl;
+    cout << endl;
+    // prints max heap data
+    cout << "------------Max Heap------------" << endl;
+    cout << "size = " << maxHeap.m_heapSize << ", ";
+    cout << "capacity = " << HEAP_CAP << endl;
+    for (int i=1; i <= maxHeap.m_heapSize; i++){
+        cout << "Heap[" << i << "] = (" << maxHeap.m_heap[i] << ")"<< endl;
+    }
+    cout << endl;
+
+    // prints min heap data
+    cout << "------------Min Heap------------" << endl;
+    cout << "size = " << minHeap.m_heapSize << ", ";
+    cout << "capacity = " << HEAP_CAP << endl;
+    for (int i=1; i <= minHeap.m_heapSize; i++){
+        cout << "Heap[" << i << "] = (" << minHeap.m_heap[i] << ")" << endl;
+    }
+
+    cout << "--------------------------------" << endl;
+    if (size() > 0){
+        cout << "min    = " << m_min << endl;
+        cout << "median = " << getMedian() << endl;
+        cout << "max    = " << m_max << endl;
+    }
+}
+
+// returns the number of items in the max heap
+template <typename T, int N>
+int StaticMedianHeap<T, N>::maxHeapSize() {
+    return maxHeap.m_heapSize;
+}
+
+// returns the number of items in the min heap
+template <typename T, int N>
+int StaticMedianHeap<T, N>::minHeapSize() {
+    return minHeap.m_heapSize;
+}
+
+// returns a copy of the item in position pos in the max heap
+template <typename T, int N>
+T StaticMedianHeap<T, N>::locateInMaxHeap(int pos) {
+    // if pos is invalid, throw error
+    if(pos < 1 || pos > maxHeapSize()){
+        throw out_of_range("Position specified is invalid or out of range.");
+    }
+    return maxHeap.m_heap[pos];
+}
+
+// returns a copy of the item in position pos in the min heap
+template <typename T, int N>
+T StaticMedianHeap<T, N>::locateInMinHeap(int pos) {
+    // if pos is invalid, throw error
+    if(pos < 1 || pos > minHeapSize()){
+        throw out_of_range("Position specified is invalid or out of range.");
+    }
+    return minHeap.m_heap[pos];
+}
+
+#endif
@@ -0,0 +1,497 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    TrimmedMedianHeap.h
+*/
+
+#ifndef _TRIMMEDMEDIANHEAP_H_
+#define _TRIMMEDMEDIANHEAP_H_
+
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include "BoundedMedianHeap.h"
+using namespace std;
+
+// TrimmedMedianHeap is a MedianHeap that also keeps the trimmed mean, the mean
+// with the smallest and largest trim * size() items dropped. Items sit in four
+// segments in sorted order: the low tail, the lower and upper halves of what
+// is left, and the high tail. Each segment is a pair of SlotHeaps, one ordered
+// each way, so its smallest and largest items can both move to the segment
+// next to it in O(log n). Segments keep a running sum and sum of squares, so
+// the trimmed mean, the mean of each half and their variances are O(1) reads.
+// The median is the largest item of the lower half, same as MedianHeap.
+template <typename T>
+class TrimmedMedianHeap {
+    static_assert(is_arithmetic<T>::value, "TrimmedMedianHeap needs a number type");
+public:
+    // constructor for TrimmedMedianHeap class
+    // trim is the share of items dropped from each end, from 0 up to but not 0.5
+    TrimmedMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap=100,
+                       double trim=0.1 ) ;
+
+    // copy constructor
+    TrimmedMedianHeap(const TrimmedMedianHeap<T>& otherH) ;
+
+    // destructor
+    ~TrimmedMedianHeap() ;
+
+    // overloaded assignment operator
+    const TrimmedMedianHeap<T>& operator=(const TrimmedMedianHeap<T>& rhs) ;
+
+    // returns the total number of items in the TrimmedMedianHeap
+    int size() ;
+
+    // returns the maximum number of items that can be stored in the TrimmedMedianHeap
+    int capacity() ;
+
+    // changes the share of items dropped from each end
+    void setTrim(double trim) ;
+
+    // returns the share of items dropped from each end
+    double getTrim() ;
+
+    // adds the item given in the parameter to the TrimmedMedianHeap
+    void insert(const T& item) ;
+
+    // returns a copy of the median key object
+    T getMedian() ;
+
+    // returns a copy of the minimum key object
+    T getMin() ;
+
+    // returns a copy of the maximum key object
+    T getMax() ;
+
+    // deletes specified item, returns true if found and false if unfound
+    bool deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) ;
+
+    // returns the mean of every item
+    double getMean() ;
+
+    // returns the mean of the items left once both tails are dropped
+    double getTrimmedMean() ;
+
+    // returns the mean of the lower half, the items up to the median
+    double getLowerMean() ;
+
+    // returns the mean of the upper half, the items after the median
+    double getUpperMean() ;
+
+    // returns the population variance of the lower half
+    double getLowerVariance() ;
+
+    // returns the population variance of the upper half
+    double getUpperVariance() ;
+
+    // prints out each item and its segment
+    void dump() ;
+
+    // segments in sorted order
+    static const int LOW_TAIL = 0;
+    static const int LOWER = 1;
+    static const int UPPER = 2;
+    static const int HIGH_TAIL = 3;
+    static const int SEGMENTS = 4;
+
+private:
+    void add(int slot, int seg);    // puts slot in segment seg
+    void take(int slot);            // takes slot out of its segment
+    void move(int slot, int seg);   // moves slot from its segment to seg
+    void fix();     // moves items between segments until each is its target size
+    double mean(int first, int last);       // mean of segments first to last
+    double variance(int first, int last);   // population variance of segments first to last
+    void copyFrom(const TrimmedMedianHeap<T>& other);  // deep copies other into host
+
+    T *m_items;     // item in each slot
+    int *m_segment; // segment of each slot, -1 if free
+    int *m_free;    // stack of unused slots
+    int m_freeTop;  // number of unused slots
+
+    SlotHeap<T> *m_largest[SEGMENTS];   // each segment, largest on top
+    SlotHeap<T> *m_smallest[SEGMENTS];  // each segment, smallest on top
+    double m_shift;             // first item inserted while empty, subtracted before summing
+    double m_sum[SEGMENTS];     // sum of items minus m_shift in each segment
+    double m_sumSq[SEGMENTS];   // sum of squares of items minus m_shift in each segment
+
+    double m_trim;  // share of items in each tail
+    int m_capacity; // capacity of heap
+    bool (*less) (const T&, const T&);
+    bool (*greater) (const T&, const T&);
+};
+
+// constructor for TrimmedMedianHeap class
+// every slot starts on the free stack
+template <typename T>
+TrimmedMedianHeap<T>::TrimmedMedianHeap( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&), int cap,
+                                         double trim ) {
+    if (cap < 1){
+        throw out_of_range("Capacity must be at least one.");
+    }
+    if (!(trim >= 0 && trim < 0.5)){
+        throw out_of_range("Trim must be at least 0 and less than 0.5.");
+    }
+    m_capacity = cap;
+    m_trim = trim;
+    less = lt;
+    greater = gt;
+
+    m_items = new T[cap];
+    m_segment = new int[cap];
+    m_free = new int[cap];
+    m_freeTop = 0;
+    m_shift = 0;
+    for (int i = cap - 1; i >= 0; i--){
+        m_segment[i] = -1;
+        m_free[m_freeTop++] = i;
+    }
+    for (int s=0; s < SEGMENTS; s++){
+        m_largest[s] = new SlotHeap<T>(cap, gt);
+        m_smallest[s] = new SlotHeap<T>(cap, lt);
+        m_sum[s] = 0;
+        m_sumSq[s] = 0;
+    }
+}
+
+// TrimmedMedianHeap class copy constructor
+// creates a deep copy of the passed in TrimmedMedianHeap object
+template <typename T>
+TrimmedMedianHeap<T>::TrimmedMedianHeap(const TrimmedMedianHeap<T>& otherH) {
+    copyFrom(otherH);
+}
+
+// TrimmedMedianHeap class destructor
+// deallocates any dynamically allocated memory
+template <typename T>
+TrimmedMedianHeap<T>::~TrimmedMedianHeap() {
+    delete[] m_items;
+    delete[] m_segment;
+    delete[] m_free;
+    for (int s=0; s < SEGMENTS; s++){
+        delete m_largest[s];
+        delete m_smallest[s];
+    }
+    m_capacity = 0;
+}
+
+// TrimmedMedianHeap class overloaded assignment operator
+// deallocates memory of the host object and copies rhs into host
+template <typename T>
+const TrimmedMedianHeap<T>& TrimmedMedianHeap<T>::operator=(const TrimmedMedianHeap<T>& rhs) {
+    // checks first for self-assignment, if true returns object
+    if(this == &rhs){
+        return *this;
+    }
+    delete[] m_items;
+    delete[] m_segment;
+    delete[] m_free;
+    for (int s=0; s < SEGMENTS; s++){
+        delete m_largest[s];
+        delete m_smallest[s];
+    }
+    copyFrom(rhs);
+    return *this;
+}
+
+// allocates arrays the same size as other's and copies every slot over
+template <typename T>
+void TrimmedMedianHeap<T>::copyFrom(const TrimmedMedianHeap<T>& other) {
+    m_capacity = other.m_capacity;
+    m_trim = other.m_trim;
+    m_freeTop = other.m_freeTop;
+    m_shift = other.m_shift;
+    less = other.less;
+    greater = other.greater;
+
+    m_items = new T[m_capacity];
+    m_segment = new int[m_capacity];
+    m_free = new int[m_capacity];
+    for (int i=0; i < m_capacity; i++){
+        m_items[i] = other.m_items[i];
+        m_segment[i] = other.m_segment[i];
+        m_free[i] = other.m_free[i];
+    }
+    for (int s=0; s < SEGMENTS; s++){
+        m_largest[s] = new SlotHeap<T>(*(other.m_largest[s]));
+        m_smallest[s] = new SlotHeap<T>(*(other.m_smallest[s]));
+        m_sum[s] = other.m_sum[s];
+        m_sumSq[s] = other.m_sumSq[s];
+    }
+}
+
+// returns the total number of items in the TrimmedMedianHeap
+template <typename T>
+int TrimmedMedianHeap<T>::size() {
+    return m_capacity - m_freeTop;
+}
+
+// returns the maximum number of items that can be stored in the TrimmedMedianHeap
+template <typename T>
+int TrimmedMedianHeap<T>::capacity() {
+    return m_capacity;
+}
+
+// changes trim and moves items into or out of the tails to match
+template <typename T>
+void TrimmedMedianHeap<T>::setTrim(double trim) {
+    if (!(trim >= 0 && trim < 0.5)){
+        throw out_of_range("Trim must be at least 0 and less than 0.5.");
+    }
+    m_trim = trim;
+    fix();
+}
+
+// returns the share of items dropped from each end
+template <typename T>
+double TrimmedMedianHeap<T>::getTrim() {
+    return m_trim;
+}
+
+// puts slot in both heaps of seg and adds its item to seg's sums
+template <typename T>
+void TrimmedMedianHeap<T>::add(int slot, int seg) {
+    double x = (double)m_items[slot] - m_shift;
+    m_segment[slot] = seg;
+    m_largest[seg]->insert(slot, m_items);
+    m_smallest[seg]->insert(slot, m_items);
+    m_sum[seg] += x;
+    m_sumSq[seg] += x * x;
+}
+
+// takes slot out of both heaps of its segment and its item out of the sums
+template <typename T>
+void TrimmedMedianHeap<T>::take(int slot) {
+    int seg = m_segment[slot];
+    double x = (double)m_items[slot] - m_shift;
+    m_largest[seg]->remove(slot, m_items);
+    m_smallest[seg]->remove(slot, m_items);
+    m_sum[seg] -= x;
+    m_sumSq[seg] -= x * x;
+    m_segment[slot] = -1;
+}
+
+// moves slot to segment seg
+template <typename T>
+void TrimmedMedianHeap<T>::move(int slot, int seg) {
+    take(slot);
+    add(slot, seg);
+}
+
+// each tail should hold trim * size() items and the halves split the rest,
+// lower getting the extra one. Boundaries are fixed from the bottom up: one
+// with too many items below it passes its largest up, one with too few pulls
+// in the smallest from the first segment above it that has any
+template <typename T>
+void TrimmedMedianHeap<T>::fix() {
+    int n = size();
+    int tail = (int)(m_trim * n);
+    int body = n - 2 * tail;
+    int target[SEGMENTS] = { tail, body - body / 2, body / 2, tail };
+
+    int below = 0;  // items in segments below boundary
+    int wanted = 0; // items that should be below boundary
+    for (int s=0; s < SEGMENTS - 1; s++){
+        below += m_largest[s]->size();
+        wanted += target[s];
+        while (below > wanted){
+            move(m_largest[s]->top(), s + 1);
+            below--;
+        }
+        while (below < wanted){
+            int from = s + 1;
+            while (m_smallest[from]->size() == 0){
+                from++;
+            }
+            move(m_smallest[from]->top(), s);
+            below++;
+        }
+    }
+}
+
+// adds item to the segment it falls in, then fixes the segment sizes
+template <typename T>
+void TrimmedMedianHeap<T>::insert(const T& item) {
+    // if TrimmedMedianHeap is full throw out of range error
+    if(size() == capacity()){
+        throw out_of_range("The TrimmedMedianHeap is full. Cannot insert item.");
+    }
+    // sums are kept relative to an item near the rest, so big items close
+    // together don't cancel away the variance
+    if (size() == 0){
+        m_shift = (double)item;
+        for (int s=0; s < SEGMENTS; s++){
+            m_sum[s] = 0;
+            m_sumSq[s] = 0;
+        }
+    }
+    int slot = m_free[--m_freeTop];
+    m_items[slot] = item;
+
+    int seg = UPPER;
+    if (m_largest[LOW_TAIL]->size() > 0 && less(item, m_items[m_largest[LOW_TAIL]->top()])){
+        seg = LOW_TAIL;
+    }
+    else if (m_smallest[HIGH_TAIL]->size() > 0 && greater(item, m_items[m_smallest[HIGH_TAIL]->top()])){
+        seg = HIGH_TAIL;
+    }
+    else if (m_largest[LOWER]->size() > 0 && !greater(item, m_items[m_largest[LOWER]->top()])){
+        seg = LOWER;
+    }
+    add(slot, seg);
+    fix();
+}
+
+// returns a copy of the median, the largest item of the lower half
+template <typename T>
+T TrimmedMedianHeap<T>::getMedian() {
+    if(size() == 0){
+        throw out_of_range("The TrimmedMedianHeap is empty.");
+    }
+    return m_items[m_largest[LOWER]->top()];
+}
+
+// returns a copy of the min, from the first segment holding any items
+template <typename T>
+T TrimmedMedianHeap<T>::getMin() {
+    if(size() == 0){
+        throw out_of_range("The TrimmedMedianHeap is empty.");
+    }
+    int s = LOW_TAIL;
+    while (m_smallest[s]->size() == 0){
+        s++;
+    }
+    return m_items[m_smallest[s]->top()];
+}
+
+// returns a copy of the max, from the last segment holding any items
+template <typename T>
+T TrimmedMedianHeap<T>::getMax() {
+    if(size() == 0){
+        throw out_of_range("The TrimmedMedianHeap is empty.");
+    }
+    int s = HIGH_TAIL;
+    while (m_largest[s]->size() == 0){
+        s--;
+    }
+    return m_items[m_largest[s]->top()];
+}
+
+// looks for givenItem and if found deletes item and returns true
+// if unfound, TrimmedMedianHeap is unchanged and returns false
+template <typename T>
+bool TrimmedMedianHeap<T>::deleteItem(T& givenItem, bool (*equalTo) (const T&, const T&) ) {
+    // if the TrimmedMedianHeap is empty throw out of range error
+    if (size() == 0){
+        throw out_of_range("The heap is empty, cannot remove item.");
+    }
+    for (int slot=0; slot < m_capacity; slot++){
+        if (m_segment[slot] != -1 && equalTo(m_items[slot], givenItem)){
+            givenItem = m_items[slot];
+            take(slot);
+            m_free[m_freeTop++] = slot;
+            fix();
+            return true;
+        }
+    }
+    return false;
+}
+
+// returns sum over count for segments first to last
+template <typename T>
+double TrimmedMedianHeap<T>::mean(int first, int last) {
+    double sum = 0;
+    int count = 0;
+    for (int s = first; s <= last; s++){
+        sum += m_sum[s];
+        count += m_largest[s]->size();
+    }
+    if (count == 0){
+        throw out_of_range("No items to take the mean of.");
+    }
+    return m_shift + sum / count;
+}
+
+// returns mean of squares minus square of mean for segments first to last,
+// both taken relative to m_shift, only rounding can take it below 0
+template <typename T>
+double TrimmedMedianHeap<T>::variance(int first, int last) {
+    double sum = 0;
+    double sumSq = 0;
+    int count = 0;
+    for (int s = first; s <= last; s++){
+        sum += m_sum[s];
+        sumSq += m_sumSq[s];
+        count += m_largest[s]->size();
+    }
+    if (count == 0){
+        throw out_of_range("No items to take the variance of.");
+    }
+    double avg = sum / count;
+    double var = sumSq / count - avg * avg;
+    return var > 0 ? var : 0;
+}
+
+// returns the mean of every item
+template <typename T>
+double TrimmedMedianHeap<T>::getMean() {
+    return mean(LOW_TAIL, HIGH_TAIL);
+}
+
+// returns the mean of the two halves without the tails
+template <typename T>
+double TrimmedMedianHeap<T>::getTrimmedMean() {
+    return mean(LOWER, UPPER);
+}
+
+// returns the mean of the low tail and lower half
+template <typename T>
+double TrimmedMedianHeap<T>::getLowerMean() {
+    return mean(LOW_TAIL, LOWER);
+}
+
+// returns the mean of the upper half and high tail
+template <typename T>
+double TrimmedMedianHeap<T>::getUpperMean() {
+    return mean(UPPER, HIGH_TAIL);
+}
+
+// returns the variance of the low tail and lower half
+template <typename T>
+double TrimmedMedianHeap<T>::getLowerVariance() {
+    return variance(LOW_TAIL, LOWER);
+}
+
+// returns the variance of the upper half and high tail
+template <typename T>
+double TrimmedMedianHeap<T>::getUpperVariance() {
+    return variance(UPPER, HIGH_TAIL);
+}
+
+// prints out each item in slot order and which segment it is in
+template <typename T>
+void TrimmedMedianHeap<T>::dump() {
+    const char *names[SEGMENTS] = { " low tail", " lower", " upper", " high tail" };
+    cout << "... TrimmedMedianHeap()::dump() ..." << endl;
+    cout << endl;
+    cout << "size = " << size() << ", ";
+    cout << "capacity = " << m_capacity << ", ";
+    cout << "trim = " << m_trim << endl;
+    int i = 1;
+    for (int slot=0; slot < m_capacity; slot++){
+        if (m_segment[slot] != -1){
+            cout << "Item[" << i << "] = (" << m_items[slot] << ")" << names[m_segment[slot]] << endl;
+            i++;
+        }
+    }
+    cout << "--------------------------------" << endl;
+    if (size() > 0){
+        cout << "min    = " << getMin() << endl;
+        cout << "median = " << getMedian() << endl;
+        cout << "max    = " << getMax() << endl;
+        cout << "trimmed mean = " << getTrimmedMean() << endl;
+    }
+}
+
+#endif
@@ -0,0 +1,409 @@
+/*
+    Name:    Anna Devadas
+    UserId:  UY38419
+    Course:  CMSC341, Sec 01
+    Project: Project 4
+    File:    WindowedMedian.h
+*/
+
+#ifndef _WINDOWEDMEDIAN_H_
+#define _WINDOWEDMEDIAN_H_
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+using namespace std;
+
+// WindowedMedian keeps the samples of the last maxWindow time units in a ring
+// of fixed width buckets. Every sample is inserted once, into the bucket for its
+// time, and any window length up to maxWindow can be queried from the same
+// buckets. Buckets are sorted once when first queried, and the median of a
+// window is selected across the sorted buckets without merging them.
+// Expiring a bucket only resets its size, so its array gets reused.
+template <typename T>
+class WindowedMedian {
+public:
+    // constructor for WindowedMedian class
+    // bucketWidth is the time covered by each bucket and maxWindow is the longest
+    // window that can be queried, both in the same units as insert times
+    WindowedMedian( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&),
+                    long long bucketWidth, long long maxWindow ) ;
+
+    // copy constructor
+    WindowedMedian(const WindowedMedian<T>& otherW) ;
+
+    // destructor
+    ~WindowedMedian() ;
+
+    // overloaded assignment operator
+    const WindowedMedian<T>& operator=(const WindowedMedian<T>& rhs) ;
+
+    // adds item with timestamp time, moves the window forward if time is newer
+    void insert(const T& item, long long time) ;
+
+    // moves window forward to time, expiring buckets that fall out of maxWindow
+    void advance(long long time) ;
+
+    // returns the number of items in the last window time units
+    int size(long long window) ;
+
+    // returns a copy of the median of the last window time units
+    T getMedian(long long window) ;
+
+    // returns a copy of the k-th smallest item of the last window time units
+    T select(long long window, int k) ;
+
+    // prints out the number of items in each live bucket
+    void dump() ;
+
+private:
+    struct Bucket {
+        T *items;       // samples that fall in this bucket
+        int size;       // number of samples in bucket
+        int cap;        // length of items array
+        long long id;   // time / bucketWidth rounded down of this bucket
+        bool sorted;    // true if items is sorted
+    };
+
+    int slot(long long id);     // index in ring of bucket id
+    long long bucketId(long long time);     // id of the bucket time falls in
+    int windowBuckets(long long window);    // number of buckets a window covers
+    void sortBucket(Bucket& b);     // sorts bucket if it isn't already
+    void copyFrom(const WindowedMedian<T>& other);  // deep copies other into host
+
+    Bucket *m_buckets;  // ring of buckets, bucket id maps to id % m_numBuckets
+    int m_numBuckets;   // number of buckets in ring
+    long long m_bucketWidth;    // time covered by one bucket
+    long long m_headId; // id of newest bucket
+
+    // orders bucket indices by their midpoint item
+    struct MidLess {
+        T *mids;
+        bool (*less) (const T&, const T&);
+        bool operator()(int a, int b) const { return less(mids[a], mids[b]); }
+    };
+
+    // scratch arrays used by select, one entry per bucket
+    Bucket **m_runs;    // buckets in the queried window
+    int *m_lo;      // first active index of each bucket
+    int *m_hi;      // one past last active index of each bucket
+    int *m_lb;      // first index not less than pivot
+    int *m_ub;      // first index greater than pivot
+    T *m_mids;      // midpoint item of each active range
+    int *m_order;   // buckets with active ranges, sorted by midpoint
+
+    bool (*less) (const T&, const T&);
+    bool (*greater) (const T&, const T&);
+};
+
+// constructor for WindowedMedian class
+// creates enough buckets to cover maxWindow, the newest bucket counts as one
+template <typename T>
+WindowedMedian<T>::WindowedMedian( bool (*lt) (const T&, const T&), bool (*gt) (const T&, const T&),
+                                   long long bucketWidth, long long maxWindow ) {
+    if(bucketWidth <= 0 || maxWindow < bucketWidth){
+        throw out_of_range("Bucket width or max window is invalid.");
+    }
+    m_bucketWidth = bucketWidth;
+    m_numBuckets = (int)((maxWindow + bucketWidth - 1) / bucketWidth);
+    m_headId = 0;
+
+    // ring starts out holding the empty buckets just before time 0
+    m_buckets = new Bucket[m_numBuckets];
+    for (int i=0; i < m_numBuckets; i++){
+        m_buckets[i].items = NULL;
+        m_buckets[i].size = 0;
+        m_buckets[i].cap = 0;
+        m_buckets[i].id = (i == 0) ? 0 : i - m_numBuckets;
+        m_buckets[i].sorted = true;
+    }
+
+    m_runs = new Bucket*[m_numBuckets];
+    m_lo = new int[m_numBuckets];
+    m_hi = new int[m_numBuckets];
+    m_lb = new int[m_numBuckets];
+    m_ub = new int[m_numBuckets];
+    m_mids = new T[m_numBuckets];
+    m_order = new int[m_numBuckets];
+
+    less = lt;
+    greater = gt;
+}
+
+// WindowedMedian class copy constructor
+// creates a deep copy of the passed in WindowedMedian object
+template <typename T>
+WindowedMedian<T>::WindowedMedian(const WindowedMedian<T>& otherW) {
+    copyFrom(otherW);
+}
+
+// WindowedMedian class destructor
+// deallocates every bucket and the scratch arrays
+template <typename T>
+WindowedMedian<T>::~WindowedMedian() {
+    for (int i=0; i < m_numBuckets; i++){
+        delete[] m_buckets[i].items;
+    }
+    delete[] m_buckets;
+    delete[] m_runs;
+    delete[] m_lo;
+    delete[] m_hi;
+    delete[] m_lb;
+    delete[] m_ub;
+    delete[] m_mids;
+    delete[] m_order;
+    m_buckets = NULL;
+    m_numBuckets = 0;
+}
+
+// WindowedMedian class overloaded assignment operator
+// deallocates memory of the host object and copies rhs into host
+template <typename T>
+const WindowedMedian<T>& WindowedMedian<T>::operator=(const WindowedMedian<T>& rhs) {
+    // checks first for self-assignment, if true returns object
+    if(this == &rhs){
+        return *this;
+    }
+
+    for (int i=0; i < m_numBuckets; i++){
+        delete[] m_buckets[i].items;
+    }
+    delete[] m_buckets;
+    delete[] m_runs;
+    delete[] m_lo;
+    delete[] m_hi;
+    delete[] m_lb;
+    delete[] m_ub;
+    delete[] m_mids;
+    delete[] m_order;
+    copyFrom(rhs);
+
+    return *this;
+}
+
+// allocates buckets the same size as other's and copies their items over
+template <typename T>
+void WindowedMedian<T>::copyFrom(const WindowedMedian<T>& other) {
+    m_numBuckets = other.m_numBuckets;
+    m_bucketWidth = other.m_bucketWidth;
+    m_headId = other.m_headId;
+    less = other.less;
+    greater = other.greater;
+
+    m_buckets = new Bucket[m_numBuckets];
+    for (int i=0; i < m_numBuckets; i++){
+        m_buckets[i] = other.m_buckets[i];
+        m_buckets[i].items = NULL;
+        if (m_buckets[i].cap > 0){
+            m_buckets[i].items = new T[m_buckets[i].cap];
+            for (int j=0; j < m_buckets[i].size; j++){
+                m_buckets[i].items[j] = other.m_buckets[i].items[j];
+            }
+        }
+    }
+
+    m_runs = new Bucket*[m_numBuckets];
+    m_lo = new int[m_numBuckets];
+    m_hi = new int[m_numBuckets];
+    m_lb = new int[m_numBuckets];
+    m_ub = new int[m_numBuckets];
+    m_mids = new T[m_numBuckets];
+    m_order = new int[m_numBuckets];
+}
+
+// moves window forward, clearing each bucket that is reused for a newer id
+template <typename T>
+void WindowedMedian<T>::advance(long long time) {
+    long long newId = bucketId(time);
+    if (newId <= m_headId){
+        return;
+    }
+    // only need to clear at most one full lap of the ring
+    long long first = newId - m_numBuckets + 1;
+    if (first < m_headId + 1){
+        first = m_headId + 1;
+    }
+    for (long long id = first; id <= newId; id++){
+        Bucket& b = m_buckets[slot(id)];
+        b.size = 0;
+        b.id = id;
+        b.sorted = true;
+    }
+    m_headId = newId;
+}
+
+// appends item to the bucket for time, growing the bucket if it is full
+template <typename T>
+void WindowedMedian<T>::insert(const T& item, long long time) {
+    advance(time);
+    long long id = bucketId(time);
+    // if time is older than the oldest bucket throw error
+    if (id <= m_headId - m_numBuckets){
+        throw out_of_range("Item time is older than the max window.");
+    }
+
+    Bucket& b = m_buckets[slot(id)];
+    if (b.size == b.cap){
+        // double bucket array, keeping the items already in it
+        int newCap = (b.cap == 0) ? 16 : b.cap * 2;
+        T *grown = new T[newCap];
+        for (int i=0; i < b.size; i++){
+            grown[i] = b.items[i];
+        }
+        delete[] b.items;
+        b.items = grown;
+        b.cap = newCap;
+    }
+    b.items[b.size] = item;
+    b.size++;
+    b.sorted = false;
+}
+
+// returns index in ring of bucket id, ids before time 0 are negative
+template <typename T>
+int WindowedMedian<T>::slot(long long id) {
+    int s = (int)(id % m_numBuckets);
+    if (s < 0){
+        s += m_numBuckets;
+    }
+    return s;
+}
+
+// returns time / bucketWidth rounded down, so times before 0 get their own
+// negative ids instead of sharing bucket 0 with the times just after it
+template <typename T>
+long long WindowedMedian<T>::bucketId(long long time) {
+    return time / m_bucketWidth - (time % m_bucketWidth < 0);
+}
+
+// returns number of buckets the last window time units cover
+template <typename T>
+int WindowedMedian<T>::windowBuckets(long long window) {
+    if (window <= 0 || window > m_numBuckets * m_bucketWidth){
+        throw out_of_range("Window length is invalid or out of range.");
+    }
+    return (int)((window + m_bucketWidth - 1) / m_bucketWidth);
+}
+
+// sorts items of bucket if any were added since the last sort
+template <typename T>
+void WindowedMedian<T>::sortBucket(Bucket& b) {
+    if (!b.sorted){
+        sort(b.items, b.items + b.size, less);
+        b.sorted = true;
+    }
+}
+
+// returns the number of items in the last window time units
+template <typename T>
+int WindowedMedian<T>::size(long long window) {
+    int nb = windowBuckets(window);
+    int total = 0;
+    for (int i=0; i < nb; i++){
+        total += m_buckets[slot(m_headId - i)].size;
+    }
+    return total;
+}
+
+// returns a copy of the median of the last window time units
+// for an even number of items this is the lower middle, same as MedianHeap
+template <typename T>
+T WindowedMedian<T>::getMedian(long long window) {
+    int n = size(window);
+    if (n == 0){
+        throw out_of_range("The window is empty.");
+    }
+    return select(window, (n + 1) / 2);
+}
+
+// returns a copy of the k-th smallest item in the last window time units
+// each round the weighted median of the bucket midpoints is used as a pivot,
+// which removes at least a quarter of the remaining items
+template <typename T>
+T WindowedMedian<T>::select(long long window, int k) {
+    int nb = windowBuckets(window);
+    if (k < 1 || k > size(window)){
+        throw out_of_range("Rank specified is invalid or out of range.");
+    }
+
+    // every bucket in window starts with its full range active
+    for (int i=0; i < nb; i++){
+        m_runs[i] = &m_buckets[slot(m_headId - i)];
+        sortBucket(*m_runs[i]);
+        m_lo[i] = 0;
+        m_hi[i] = m_runs[i]->size;
+    }
+
+    MidLess byMid;
+    byMid.mids = m_mids;
+    byMid.less = less;
+
+    while (true){
+        // collect midpoint of each non-empty range
+        int m = 0;
+        long long total = 0;
+        for (int i=0; i < nb; i++){
+            if (m_hi[i] > m_lo[i]){
+                m_mids[i] = m_runs[i]->items[(m_lo[i] + m_hi[i]) / 2];
+                m_order[m] = i;
+                total += m_hi[i] - m_lo[i];
+                m++;
+            }
+        }
+        // pivot is the midpoint at the weighted median, weighted by range length
+        sort(m_order, m_order + m, byMid);
+        long long acc = 0;
+        T pivot = m_mids[m_order[0]];
+        for (int i=0; i < m; i++){
+            int r = m_order[i];
+            acc += m_hi[r] - m_lo[r];
+            if (2 * acc >= total){
+                pivot = m_mids[r];
+                break;
+            }
+        }
+
+        // count active items less than and equal to pivot
+        long long numLess = 0;
+        long long numEqual = 0;
+        for (int i=0; i < nb; i++){
+            T *items = m_runs[i]->items;
+            m_lb[i] = (int)(lower_bound(items + m_lo[i], items + m_hi[i], pivot, less) - items);
+            m_ub[i] = (int)(upper_bound(items + m_lb[i], items + m_hi[i], pivot, less) - items);
+            numLess += m_lb[i] - m_lo[i];
+            numEqual += m_ub[i] - m_lb[i];
+        }
+
+        // keep the side k is on
+        if (k <= numLess){
+            for (int i=0; i < nb; i++){
+                m_hi[i] = m_lb[i];
+            }
+        }
+        else if (k <= numLess + numEqual){
+            return pivot;
+        }
+        else {
+            k -= (int)(numLess + numEqual);
+            for (int i=0; i < nb; i++){
+                m_lo[i] = m_ub[i];
+            }
+        }
+    }
+}
+
+// prints out bucket data from newest to oldest
+template <typename T>
+void WindowedMedian<T>::dump() {
+    cout << "... WindowedMedian()::dump() ..." << endl;
+    cout << endl;
+    cout << "buckets = " << m_numBuckets << ", ";
+    cout << "bucket width = " << m_bucketWidth << endl;
+    for (int i=0; i < m_numBuckets; i++){
+        Bucket& b = m_buckets[slot(m_headId - i)];
+        cout << "Bucket[" << b.id << "] size = " << b.size << endl;
+    }
+    cout << "--------------------------------" << endl;
+}
+
+#endif